@@ -0,0 +1,274 @@
+#ifndef DOCUMENTATION_CACHE_H
+#define DOCUMENTATION_CACHE_H
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include "../utils/ContentHash.h"
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+// Disk-backed store of generated documentation. Entries are keyed by everything
+// that determines the LLM output (repository content hash, mapped doc type,
+// audience, model, prompt template version), so an unchanged repository is
+// served from disk instead of a 30-300 s generation. An in-memory index
+// tracks sizes and last access; the least recently used entries are deleted
+// once the total exceeds DOC_CACHE_MB. Hits only touch the in-memory index;
+// it is written out on put, at most once a minute after hits, and on shutdown.
+class DocumentationCache {
+public:
+    struct Key {
+        std::string content_hash;
+        std::string doc_type;
+        std::string audience;
+        std::string model;
+        std::string template_version;
+    };
+
+private:
+    struct CacheEntry {
+        std::string repo_id;
+        Key key;
+        long long size_bytes = 0;
+        long long created = 0;
+        long long last_access = 0;     // seconds since epoch
+    };
+
+    std::string cache_path;
+    std::string index_path;
+    long long budget_bytes;
+    std::mutex mutex;
+    std::map<std::string, CacheEntry> entries;
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+    bool dirty = false;                // in-memory index has changes not yet in index.json
+    long long last_saved = 0;
+    static constexpr long long ACCESS_FLUSH_SECONDS = 60;
+
+    static long long nowSeconds() {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    static std::string entryId(const Key& key) {
+        return ContentHash::sha256(key.content_hash + "\n" + key.doc_type + "\n" + key.audience + "\n" +
+                                   key.model + "\n" + key.template_version);
+    }
+
+    std::string entryFile(const std::string& id) const {
+        return cache_path + "/" + id + ".md";
+    }
+
+    std::string manifestFile(const std::string& repo_id, const std::string& doc_type, const std::string& audience) const {
+        return cache_path + "/manifests/" + ContentHash::sha256(repo_id + "\n" + doc_type + "\n" + audience) + ".json";
+    }
+
+    long long usedBytes() const {
+        long long used = 0;
+        for (const auto& [_, entry] : entries) used += entry.size_bytes;
+        return used;
+    }
+
+    // Persist the index (caller holds the mutex)
+    void save() {
+        json index = json::object();
+        for (const auto& [id, entry] : entries) {
+            index[id] = {
+                {"repo_id", entry.repo_id},
+                {"content_hash", entry.key.content_hash},
+                {"doc_type", entry.key.doc_type},
+                {"audience", entry.key.audience},
+                {"model", entry.key.model},
+                {"template_version", entry.key.template_version},
+                {"size_bytes", entry.size_bytes},
+                {"created", entry.created},
+                {"last_access", entry.last_access}
+            };
+        }
+
+        std::string tmp_path = index_path + ".tmp";
+        std::ofstream out(tmp_path);
+        out << index.dump(2);
+        out.close();
+        fs::rename(tmp_path, index_path);
+
+        dirty = false;
+        last_saved = nowSeconds();
+    }
+
+    void load() {
+        if (!fs::exists(index_path)) return;
+
+        try {
+            std::ifstream file(index_path);
+            json index;
+            file >> index;
+
+            for (auto& [id, value] : index.items()) {
+                if (!fs::exists(entryFile(id))) continue;
+
+                CacheEntry entry;
+                entry.repo_id = value.value("repo_id", "");
+                entry.key = {value.value("content_hash", ""), value.value("doc_type", ""),
+                             value.value("audience", ""), value.value("model", ""),
+                             value.value("template_version", "")};
+                entry.size_bytes = value.value("size_bytes", 0LL);
+                entry.created = value.value("created", 0LL);
+                entry.last_access = value.value("last_access", 0LL);
+                entries[id] = entry;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "⚠ Ignoring unreadable documentation cache index: " << e.what() << std::endl;
+        }
+    }
+
+    // Delete least recently used entries until the cache fits its budget (caller holds the mutex)
+    void evictToBudget(const std::string& keep_id) {
+        while (usedBytes() > budget_bytes) {
+            std::string victim;
+            long long oldest = 0;
+            for (const auto& [id, entry] : entries) {
+                if (id == keep_id) continue;
+                if (victim.empty() || entry.last_access < oldest) {
+                    victim = id;
+                    oldest = entry.last_access;
+                }
+            }
+            if (victim.empty()) break;
+
+            std::error_code ec;
+            fs::remove(entryFile(victim), ec);
+            entries.erase(victim);
+            evictions++;
+        }
+    }
+
+public:
+    DocumentationCache() {
+        const char* path = std::getenv("DOC_CACHE_PATH");
+        cache_path = path ? path : "./data/doc_cache";
+        fs::create_directories(cache_path + "/manifests");
+        index_path = cache_path + "/index.json";
+
+        const char* budget = std::getenv("DOC_CACHE_MB");
+        budget_bytes = (budget ? std::atoll(budget) : 256) * 1024 * 1024;
+
+        load();
+        last_saved = nowSeconds();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        std::cout << "✓ Documentation cache: " << entries.size() << " entries ("
+                  << usedBytes() / 1024 << " KB) at " << cache_path << std::endl;
+    }
+
+    ~DocumentationCache() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (dirty) save();
+    }
+
+    // Cached documentation for this key, if any
+    bool get(const Key& key, std::string& documentation) {
+        std::string id = entryId(key);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(id);
+        if (it == entries.end()) {
+            misses++;
+            return false;
+        }
+
+        std::ifstream file(entryFile(id));
+        if (!file) {
+            entries.erase(it);
+            dirty = true;
+            misses++;
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        documentation = buffer.str();
+
+        // Eviction order only needs to survive restarts approximately
+        long long now = nowSeconds();
+        it->second.last_access = now;
+        dirty = true;
+        hits++;
+        if (now - last_saved >= ACCESS_FLUSH_SECONDS) save();
+        return true;
+    }
+
+    void put(const std::string& repo_id, const Key& key, const std::string& documentation) {
+        std::string id = entryId(key);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string file_path = entryFile(id);
+        std::string tmp_path = file_path + ".tmp";
+        std::ofstream out(tmp_path);
+        out << documentation;
+        out.close();
+        fs::rename(tmp_path, file_path);
+
+        CacheEntry& entry = entries[id];
+        entry.repo_id = repo_id;
+        entry.key = key;
+        entry.size_bytes = static_cast<long long>(documentation.size());
+        entry.created = nowSeconds();
+        entry.last_access = entry.created;
+
+        evictToBudget(id);
+        save();
+    }
+
+    // Input manifest of the last generated document for a repository, doc type and audience:
+    // which files fed each of its sections and the text each produced. Kept outside the LRU
+    // budget (one file per document) so a regeneration can always tell what changed since the
+    // previous one and reuse the unchanged sections.
+    bool getManifest(const std::string& repo_id, const std::string& doc_type, const std::string& audience,
+                     json& manifest) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::ifstream file(manifestFile(repo_id, doc_type, audience));
+        if (!file) return false;
+
+        try {
+            file >> manifest;
+            return true;
+        } catch (const std::exception& e) {
+            std::cerr << "⚠ Ignoring unreadable documentation manifest: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    void putManifest(const std::string& repo_id, const std::string& doc_type, const std::string& audience,
+                     const json& manifest) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string file_path = manifestFile(repo_id, doc_type, audience);
+        std::string tmp_path = file_path + ".tmp";
+        std::ofstream out(tmp_path);
+        out << manifest.dump(2);
+        out.close();
+        fs::rename(tmp_path, file_path);
+    }
+
+    json getStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        json stats;
+        stats["entries"] = entries.size();
+        stats["bytes_stored"] = usedBytes();
+        stats["budget_bytes"] = budget_bytes;
+        stats["hits"] = hits;
+        stats["misses"] = misses;
+        stats["hit_ratio"] = hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0;
+        stats["evictions"] = evictions;
+        return stats;
+    }
+};
+
+#endif // DOCUMENTATION_CACHE_H
@@ -0,0 +1,476 @@
+#ifndef DOCUMENTATION_JOB_QUEUE_H
+#define DOCUMENTATION_JOB_QUEUE_H
+
+#include <string>
+#include <map>
+#include <list>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include "DocumentationService.h"
+
+using json = nlohmann::json;
+
+// Runs documentation generation on its own bounded worker pool, so an LLM call
+// (30-300 s) no longer holds a Crow request thread. Clients submit a job, get
+// its id back immediately and poll, or long-poll, for the result. A long-poll
+// holds a Crow worker thread, so only DOC_JOB_MAX_LONG_POLLS of them (default: a
+// quarter of the hardware threads Crow runs on, and at least one) wait at once;
+// beyond that a status request answers immediately and tells the client to poll
+// again. Finished jobs are kept for DOC_JOB_RETENTION_SEC so a client that
+// reconnects can still collect its document. A batch (several doc types over
+// one shared context) runs as a single job. Streamed generations run on a
+// separate set of DOC_STREAM_WORKERS threads; a stream that finds them all busy
+// is refused rather than queued, since its client is waiting on an open socket.
+class DocumentationJobQueue {
+private:
+    struct DocJob {
+        long long id;
+        std::string key;
+        std::string repo_id;
+        std::string doc_type;
+        std::string audience;
+        std::string mode;
+        bool force = false;
+        std::vector<std::pair<std::string, std::string>> batch_items;   // (doc_type, audience); empty for one document
+        std::string state = "queued";   // queued, running, completed, failed, cancelled
+        size_t queue_depth_at_submit = 0;
+        std::chrono::steady_clock::time_point enqueued_at;
+        std::chrono::steady_clock::time_point started_at;
+        std::chrono::steady_clock::time_point finished_at;
+        std::atomic<bool> cancelled{false};
+        std::atomic<size_t> generated_chars{0};
+        std::string documentation;
+        json batch;                     // generateBatch result of a completed batch job
+        bool cached = false;
+        std::string error;
+    };
+
+    std::shared_ptr<DocumentationService> doc_service;
+    size_t worker_count;
+    size_t max_queued;
+    size_t max_long_polls;
+    std::chrono::seconds retention;
+    static constexpr long long SHORT_POLL_MS = 2000;
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable job_finished;
+    std::list<std::shared_ptr<DocJob>> queue;
+    std::map<long long, std::shared_ptr<DocJob>> jobs;   // every job not yet pruned
+    long long next_job_id = 1;
+    long long completed_jobs = 0;
+    long long failed_jobs = 0;
+    long long cancelled_jobs = 0;
+    long long started_jobs = 0;
+    long long finished_runs = 0;
+    long long total_wait_ms = 0;
+    long long total_run_ms = 0;
+    size_t running_count = 0;
+    size_t active_long_polls = 0;
+    long long declined_long_polls = 0;
+    std::atomic<bool> stopping{false};
+    std::vector<std::thread> workers;
+
+    size_t stream_worker_count;
+    size_t idle_stream_workers = 0;
+    std::condition_variable stream_available;
+    std::list<std::function<void()>> stream_tasks;
+    long long started_streams = 0;
+    long long rejected_streams = 0;
+    std::vector<std::thread> stream_workers;
+
+    static long long millisBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+    }
+
+    static bool isFinished(const DocJob& job) {
+        return job.state == "completed" || job.state == "failed" || job.state == "cancelled";
+    }
+
+    // Drop finished jobs past their retention (caller holds the mutex)
+    void pruneFinished() {
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = jobs.begin(); it != jobs.end();) {
+            if (isFinished(*it->second) && now - it->second->finished_at > retention) {
+                it = jobs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Record the outcome of a job and wake long-pollers (caller holds the mutex)
+    void finishJob(DocJob& job, const std::string& state) {
+        job.state = state;
+        job.finished_at = std::chrono::steady_clock::now();
+        if (state == "completed") completed_jobs++;
+        else if (state == "failed") failed_jobs++;
+        else cancelled_jobs++;
+        job_finished.notify_all();
+    }
+
+    void workerLoop() {
+        while (true) {
+            std::shared_ptr<DocJob> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                work_available.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (stopping) return;
+
+                job = queue.front();
+                queue.pop_front();
+                job->state = "running";
+                job->started_at = std::chrono::steady_clock::now();
+                total_wait_ms += millisBetween(job->enqueued_at, job->started_at);
+                started_jobs++;
+                running_count++;
+            }
+
+            std::string state = "completed";
+            std::string documentation;
+            json batch;
+            std::string error;
+            bool cached = false;
+            try {
+                if (!job->batch_items.empty()) {
+                    batch = doc_service->generateBatch(job->repo_id, job->batch_items, job->force, &job->cancelled);
+                } else {
+                    // The streaming path makes a running job cancellable and reports progress
+                    documentation = doc_service->generateDocumentation(
+                        job->repo_id, job->doc_type, job->audience, job->mode, job->force, &cached,
+                        [&job](const std::string& chunk) {
+                            job->generated_chars += chunk.size();
+                            return true;
+                        },
+                        &job->cancelled);
+                }
+            } catch (const GenerationCancelled&) {
+                state = "cancelled";
+            } catch (const std::exception& e) {
+                state = "failed";
+                error = e.what();
+                std::cerr << "❌ Documentation job " << job->id << " (" << job->doc_type << " for "
+                          << job->repo_id << ") failed: " << e.what() << std::endl;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            running_count--;
+            job->documentation = std::move(documentation);
+            job->batch = std::move(batch);
+            job->cached = cached;
+            job->error = error;
+            total_run_ms += millisBetween(job->started_at, std::chrono::steady_clock::now());
+            finished_runs++;
+            finishJob(*job, state);
+        }
+    }
+
+    void streamWorkerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                stream_available.wait(lock, [this] { return stopping || !stream_tasks.empty(); });
+                if (stopping) return;
+
+                task = std::move(stream_tasks.front());
+                stream_tasks.pop_front();
+            }
+
+            try {
+                task();
+            } catch (const std::exception& e) {
+                std::cerr << "❌ Streamed generation failed: " << e.what() << std::endl;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            idle_stream_workers++;
+        }
+    }
+
+    // Find an unfinished job for the same request (caller holds the mutex)
+    std::shared_ptr<DocJob> findPending(const std::string& key) {
+        for (const auto& [_, job] : jobs) {
+            if (job->key == key && (job->state == "queued" || job->state == "running")) return job;
+        }
+        return nullptr;
+    }
+
+    // Position of a queued job, 1-based (caller holds the mutex)
+    size_t queuePosition(const DocJob& job) const {
+        size_t position = 0;
+        for (const auto& queued : queue) {
+            ++position;
+            if (queued->id == job.id) return position;
+        }
+        return 0;
+    }
+
+    json describeJob(const DocJob& job, bool include_result) const {
+        auto now = std::chrono::steady_clock::now();
+        json entry;
+        entry["job_id"] = job.id;
+        entry["repo_id"] = job.repo_id;
+        entry["doc_type"] = job.doc_type;
+        entry["audience"] = job.audience;
+        entry["state"] = job.state;
+        entry["queue_depth_at_submit"] = job.queue_depth_at_submit;
+
+        if (job.state == "queued") {
+            entry["position"] = queuePosition(job);
+            entry["waiting_ms"] = millisBetween(job.enqueued_at, now);
+        } else {
+            entry["waited_ms"] = millisBetween(job.enqueued_at, job.started_at);
+            entry["running_ms"] = millisBetween(job.started_at, isFinished(job) ? job.finished_at : now);
+            entry["generated_chars"] = job.generated_chars.load();
+        }
+
+        if (!job.batch_items.empty()) {
+            entry["items"] = job.batch_items.size();
+        }
+
+        if (job.state == "completed") {
+            if (!job.batch_items.empty()) {
+                if (include_result) entry["batch"] = job.batch;
+            } else {
+                entry["cached"] = job.cached;
+                if (include_result) entry["documentation"] = job.documentation;
+            }
+        } else if (job.state == "failed") {
+            entry["error"] = job.error;
+        }
+        return entry;
+    }
+
+    // Queue a prepared job, or return the pending job it duplicates
+    json enqueue(const std::shared_ptr<DocJob>& job) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pruneFinished();
+
+        if (!job->force) {
+            if (auto existing = findPending(job->key)) {
+                return describeJob(*existing, false);
+            }
+        }
+
+        if (queue.size() >= max_queued) {
+            throw std::runtime_error("Documentation queue is full (" + std::to_string(queue.size()) + " jobs waiting)");
+        }
+
+        job->id = next_job_id++;
+        job->queue_depth_at_submit = queue.size();
+        job->enqueued_at = std::chrono::steady_clock::now();
+        queue.push_back(job);
+        jobs[job->id] = job;
+
+        if (queue.size() > 1 || running_count >= worker_count) {
+            std::cout << "⏳ Queued documentation job " << job->id << " (" << queue.size() << " waiting)" << std::endl;
+        }
+
+        work_available.notify_one();
+        return describeJob(*job, false);
+    }
+
+public:
+    explicit DocumentationJobQueue(std::shared_ptr<DocumentationService> service)
+        : doc_service(std::move(service)) {
+        const char* workers_env = std::getenv("DOC_JOB_WORKERS");
+        worker_count = workers_env ? std::max(1, std::atoi(workers_env)) : 2;
+
+        const char* queue_env = std::getenv("DOC_JOB_QUEUE_LIMIT");
+        max_queued = queue_env ? std::max(1, std::atoi(queue_env)) : 100;
+
+        const char* retention_env = std::getenv("DOC_JOB_RETENTION_SEC");
+        retention = std::chrono::seconds(retention_env ? std::atoi(retention_env) : 3600);
+
+        // Crow's multithreaded() runs one request thread per hardware thread
+        const char* long_poll_env = std::getenv("DOC_JOB_MAX_LONG_POLLS");
+        max_long_polls = long_poll_env
+            ? static_cast<size_t>(std::max(0, std::atoi(long_poll_env)))
+            : std::max<size_t>(1, std::thread::hardware_concurrency() / 4);
+
+        const char* stream_env = std::getenv("DOC_STREAM_WORKERS");
+        stream_worker_count = stream_env ? std::max(1, std::atoi(stream_env)) : 4;
+
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers.emplace_back(&DocumentationJobQueue::workerLoop, this);
+        }
+        idle_stream_workers = stream_worker_count;
+        for (size_t i = 0; i < stream_worker_count; ++i) {
+            stream_workers.emplace_back(&DocumentationJobQueue::streamWorkerLoop, this);
+        }
+
+        std::cout << "✓ Documentation job queue started (" << worker_count << " workers, up to "
+                  << max_queued << " queued, " << stream_worker_count << " stream workers, "
+                  << max_long_polls << " concurrent long-polls)" << std::endl;
+    }
+
+    ~DocumentationJobQueue() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& [_, job] : jobs) job->cancelled = true;
+        }
+        stopping = true;
+        work_available.notify_all();
+        stream_available.notify_all();
+        for (auto& worker : workers) worker.join();
+        // Running streams must already be cancelled by their owners, or this waits for them
+        for (auto& worker : stream_workers) worker.join();
+    }
+
+    DocumentationJobQueue(const DocumentationJobQueue&) = delete;
+    DocumentationJobQueue& operator=(const DocumentationJobQueue&) = delete;
+
+    // Queue a generation and return its description. An identical request that is still
+    // pending shares that job (unless force is set); a full queue throws.
+    json submit(
+        const std::string& repo_id,
+        const std::string& doc_type,
+        const std::string& audience,
+        const std::string& mode,
+        bool force
+    ) {
+        auto job = std::make_shared<DocJob>();
+        job->key = repo_id + "#" + doc_type + "#" + audience + "#" + mode;
+        job->repo_id = repo_id;
+        job->doc_type = doc_type;
+        job->audience = audience;
+        job->mode = mode;
+        job->force = force;
+        return enqueue(job);
+    }
+
+    // Queue a batch of (doc_type, audience) items as one job; see DocumentationService::generateBatch
+    json submitBatch(
+        const std::string& repo_id,
+        const std::vector<std::pair<std::string, std::string>>& items,
+        bool force
+    ) {
+        auto job = std::make_shared<DocJob>();
+        job->key = repo_id + "#batch";
+        for (const auto& [doc_type, audience] : items) job->key += "#" + doc_type + "/" + audience;
+        job->repo_id = repo_id;
+        job->doc_type = "batch";
+        job->batch_items = items;
+        job->force = force;
+        return enqueue(job);
+    }
+
+    // Job status with its document once completed. A positive wait long-polls: it
+    // returns as soon as the job finishes or after `wait`, whichever comes first. When
+    // max_long_polls requests are already waiting it returns at once with poll_after_ms.
+    json getJob(long long job_id, std::chrono::milliseconds wait = std::chrono::milliseconds(0)) {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto it = jobs.find(job_id);
+        if (it == jobs.end()) {
+            throw std::runtime_error("Job not found: " + std::to_string(job_id));
+        }
+
+        auto job = it->second;
+        bool declined = false;
+        if (wait.count() > 0 && !isFinished(*job)) {
+            if (active_long_polls < max_long_polls) {
+                active_long_polls++;
+                job_finished.wait_for(lock, wait, [&job, this] { return stopping || isFinished(*job); });
+                active_long_polls--;
+            } else {
+                declined = true;
+                declined_long_polls++;
+            }
+        }
+
+        json entry = describeJob(*job, true);
+        if (declined) entry["poll_after_ms"] = SHORT_POLL_MS;
+        return entry;
+    }
+
+    // Run a streamed generation on an idle stream worker. Returns false, without running
+    // it, when every stream worker is busy. The task owns its cancellation and reporting.
+    bool tryStartStream(std::function<void()> task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping || idle_stream_workers == 0) {
+            rejected_streams++;
+            return false;
+        }
+
+        idle_stream_workers--;
+        started_streams++;
+        stream_tasks.push_back(std::move(task));
+        stream_available.notify_one();
+        return true;
+    }
+
+    size_t streamWorkerCount() const {
+        return stream_worker_count;
+    }
+
+    // Cancel a queued or running job; returns false if it already finished
+    bool cancel(long long job_id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = jobs.find(job_id);
+        if (it == jobs.end()) {
+            throw std::runtime_error("Job not found: " + std::to_string(job_id));
+        }
+
+        auto job = it->second;
+        if (isFinished(*job)) return false;
+
+        job->cancelled = true;
+        if (job->state == "queued") {
+            queue.remove(job);
+            job->started_at = std::chrono::steady_clock::now();
+            finishJob(*job, "cancelled");
+        }
+        // A running job stops at its next token and is marked cancelled by its worker
+        return true;
+    }
+
+    // Queue depth, per-job timings and counters
+    json getStatus() {
+        std::lock_guard<std::mutex> lock(mutex);
+        pruneFinished();
+
+        json running_jobs = json::array();
+        json queued_jobs = json::array();
+        size_t finished = 0;
+        for (const auto& job : queue) {
+            queued_jobs.push_back(describeJob(*job, false));
+        }
+        for (const auto& [_, job] : jobs) {
+            if (job->state == "running") running_jobs.push_back(describeJob(*job, false));
+            else if (isFinished(*job)) finished++;
+        }
+
+        json status;
+        status["workers"] = worker_count;
+        status["max_queued"] = max_queued;
+        status["max_long_polls"] = max_long_polls;
+        status["active_long_polls"] = active_long_polls;
+        status["declined_long_polls"] = declined_long_polls;
+        status["queue_depth"] = queue.size();
+        status["running"] = running_jobs;
+        status["queued"] = queued_jobs;
+        status["retained_finished_jobs"] = finished;
+        status["completed_jobs"] = completed_jobs;
+        status["failed_jobs"] = failed_jobs;
+        status["cancelled_jobs"] = cancelled_jobs;
+        status["avg_wait_ms"] = started_jobs > 0 ? total_wait_ms / started_jobs : 0;
+        status["avg_run_ms"] = finished_runs > 0 ? total_run_ms / finished_runs : 0;
+        status["stream_workers"] = stream_worker_count;
+        status["active_streams"] = stream_worker_count - idle_stream_workers;
+        status["started_streams"] = started_streams;
+        status["rejected_streams"] = rejected_streams;
+        return status;
+    }
+};
+
+#endif // DOCUMENTATION_JOB_QUEUE_H
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <map>
+#include <set>
 #include <vector>
 #include <fstream>
 #include <sstream>
@@ -10,9 +11,19 @@
 #include <ctime>
 #include <algorithm>
 #include <iostream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <chrono>
 #include <nlohmann/json.hpp>
 #include "LLMService.h"
 #include "PromptTemplates.h"
+#include "DocumentationCache.h"
+#include "EmbeddingService.h"
+#include "../utils/SummaryCache.h"
+#include "../utils/ContextBuilder.h"
+#include "../utils/ContextPacker.h"
 
 namespace fs = std::filesystem;
 using json = nlohmann::json;
@@ -21,19 +32,29 @@ class DocumentationService {
 private:
     std::string summaries_path;
     std::shared_ptr<LLMService> llm_service;
-
-    // Load repository data from saved JSON
-    json loadRepositoryData(const std::string& repo_id) {
+    std::shared_ptr<DocumentationCache> doc_cache;
+    std::shared_ptr<EmbeddingService> embedding_service;
+    std::string default_generation_mode;
+    std::string batch_keep_alive;
+
+    // Map-reduce limits: parallel LLM calls and modules a repository is split into
+    size_t map_reduce_concurrency;
+    size_t map_reduce_max_modules;
+    // Section mode: parallel section requests and the output floor per section
+    size_t section_concurrency;
+    static constexpr int MIN_SECTION_TOKENS = 400;
+    static constexpr int MODULE_SUMMARY_TOKENS = 400;
+    static constexpr int MERGE_SUMMARY_TOKENS = 500;
+
+    // Load repository data from saved JSON (parsed once and shared via the summary cache)
+    std::shared_ptr<const json> loadRepositoryData(const std::string& repo_id) {
         std::string summary_file = summaries_path + "/" + repo_id + ".json";
 
         if (!fs::exists(summary_file)) {
             throw std::runtime_error("Repository data not found: " + repo_id);
         }
 
-        std::ifstream file(summary_file);
-        json data;
-        file >> data;
-        return data;
+        return SummaryCache::instance().load(repo_id, summary_file);
     }
 
     // Get current timestamp as string
@@ -44,300 +65,593 @@ private:
         return std::string(buf);
     }
 
-    // Build repository overview string
-    std::string buildRepositoryOverview(const json& repo_data) {
-        std::ostringstream overview;
-
-        int total_files = repo_data.value("analyzed_files", 0);
-        int total_lines = 0;
-        std::map<std::string, int> languages;
+    // Tokens left for repository context after the fixed prompt text, the system prompt and num_predict
+    int contextBudget(const std::string& mapped_type, const std::string& audience, const std::string& system_prompt) {
+        ModelConfig model_config = llm_service->getModelConfig();
+        std::string fixed_prompt = PromptTemplates::buildPrompt(mapped_type, audience, "", "", "");
+        int budget = model_config.context_length - model_config.num_predict -
+                     ContextPacker::estimateTokens(fixed_prompt) - ContextPacker::estimateTokens(system_prompt);
+        return std::max(budget, 0);
+    }
 
-        if (repo_data.contains("files")) {
-            for (auto& [file_path, file_info] : repo_data["files"].items()) {
-                if (file_info.contains("analysis")) {
-                    total_lines += file_info["analysis"].value("lines", 0);
-                    std::string type = file_info["analysis"].value("type", "unknown");
-                    languages[type]++;
-                }
+    // Pack repository context into the tokens left after the fixed prompt text and num_predict.
+    // When not every file fits, the files most similar to the doc type (by embedding) go first.
+    // `unprioritized` is a plain pack already made with contextBudget(), reused if given.
+    PackedContext packContext(
+        const std::string& repo_id,
+        const json& repo_data,
+        const json& context,
+        const std::string& mapped_type,
+        const std::string& audience,
+        const std::string& system_prompt,
+        const PackedContext* unprioritized = nullptr
+    ) {
+        int budget = contextBudget(mapped_type, audience, system_prompt);
+        PackedContext packed = unprioritized ? *unprioritized : ContextPacker::pack(repo_data, context, budget);
+
+        if (packed.key_files_detailed < packed.key_files_total) {
+            auto retrieved = embedding_service->retrieve(repo_id, PromptTemplates::getRetrievalQuery(mapped_type));
+            if (!retrieved.empty()) {
+                std::vector<std::string> priority;
+                for (const auto& [file_path, _] : retrieved) priority.push_back(file_path);
+                packed = ContextPacker::pack(repo_data, context, budget, priority);
+
+                std::cout << "🔎 Prioritized " << retrieved.size() << " files by similarity to " << mapped_type
+                          << " (best: " << retrieved.front().first << ", " << retrieved.front().second << ")"
+                          << std::endl;
             }
         }
 
-        overview << "- Total Files: " << total_files << "\n";
-        overview << "- Total Lines of Code: " << total_lines << "\n";
-        overview << "- Languages/Technologies: ";
-
-        for (const auto& [lang, count] : languages) {
-            overview << lang << " (" << count << " files), ";
-        }
+        std::cout << "📦 Context: ~" << packed.estimated_tokens << "/" << packed.budget_tokens
+                  << " tokens (structure: " << packed.structure_mode << ", key files: "
+                  << packed.key_files_detailed << " detailed, " << packed.key_files_listed
+                  << " listed of " << packed.key_files_total << ")" << std::endl;
+        return packed;
+    }
 
-        return overview.str();
+    // Tokens left for context in a prompt after its fixed text, the system prompt and the output
+    int promptBudget(const std::string& fixed_prompt, const std::string& system_prompt, int output_tokens) {
+        ModelConfig model_config = llm_service->getModelConfig();
+        int budget = model_config.context_length - std::min(output_tokens, model_config.num_predict) -
+                     ContextPacker::estimateTokens(fixed_prompt) - ContextPacker::estimateTokens(system_prompt);
+        return std::max(budget, 0);
     }
 
-    // Build file structure summary
-    std::string buildFileStructure(const json& repo_data) {
-        std::ostringstream structure;
+    // Run fn(0..count-1) on at most `concurrency` threads; the first failure is rethrown
+    static void parallelFor(size_t count, size_t concurrency, const std::function<void(size_t)>& fn) {
+        std::atomic<size_t> next{0};
+        std::exception_ptr failure;
+        std::mutex failure_mutex;
+
+        auto worker = [&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                try {
+                    fn(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(failure_mutex);
+                    if (!failure) failure = std::current_exception();
+                }
+            }
+        };
 
-        if (!repo_data.contains("files")) {
-            return "No file information available.\n";
-        }
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < std::min(concurrency, count); ++t) threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads) thread.join();
 
-        // Organize files by directory
-        std::map<std::string, std::vector<std::string>> dirs;
+        if (failure) std::rethrow_exception(failure);
+    }
 
-        for (auto& [file_path, file_info] : repo_data["files"].items()) {
-            fs::path p(file_path);
-            std::string dir = p.parent_path().string();
-            if (dir.empty()) dir = ".";
-            dirs[dir].push_back(p.filename().string());
+    // Split files into at most map_reduce_max_modules modules, using the deepest directory
+    // level that stays under the limit; too many top-level directories are bucketed together
+    std::vector<std::pair<std::string, json>> partitionIntoModules(const json& files) {
+        auto groupAtDepth = [&](size_t depth) {
+            std::map<std::string, json> groups;
+            for (auto& [file_path, file_info] : files.items()) {
+                fs::path dir = fs::path(file_path).parent_path();
+                fs::path prefix;
+                size_t level = 0;
+                for (const auto& part : dir) {
+                    if (level++ >= depth) break;
+                    prefix /= part;
+                }
+                std::string name = prefix.empty() ? "." : prefix.string();
+                groups[name][file_path] = file_info;
+            }
+            return groups;
+        };
+
+        std::map<std::string, json> modules = groupAtDepth(1);
+        for (size_t depth = 2; depth <= 16; ++depth) {
+            auto deeper = groupAtDepth(depth);
+            if (deeper.size() > map_reduce_max_modules) break;
+            if (deeper.size() > modules.size()) modules = std::move(deeper);
         }
 
-        // Output structure
-        for (const auto& [dir, files] : dirs) {
-            structure << "**" << dir << "/**\n";
-            for (const auto& file : files) {
-                structure << "  - " << file << "\n";
+        // Still too many (top-level directories): bucket neighbouring modules together
+        std::vector<std::pair<std::string, json>> result;
+        size_t per_bucket = (modules.size() + map_reduce_max_modules - 1) / map_reduce_max_modules;
+        size_t in_bucket = 0;
+        std::string first_name;
+        for (auto& [name, module_files] : modules) {
+            if (in_bucket == 0) {
+                first_name = name;
+                result.push_back({name, std::move(module_files)});
+            } else {
+                result.back().first = first_name + " ... " + name;
+                result.back().second.update(module_files);
             }
-            structure << "\n";
+            in_bucket = (in_bucket + 1) % per_bucket;
         }
+        return result;
+    }
+
+    // Map step: summarize one module, reusing the cached summary if its files are unchanged
+    std::string summarizeModule(const std::string& repo_id, const std::string& module_name,
+                                const json& module_files, bool& cache_hit) {
+        json module_data;
+        module_data["files"] = module_files;
+        module_data["analyzed_files"] = module_files.size();
+        json module_context = ContextBuilder::buildContext(module_data);
+
+        DocumentationCache::Key key{
+            module_context["content_hash"], "module_summary", module_name, llm_service->getModel(),
+            std::to_string(PromptTemplates::VERSION) + "." + std::to_string(ContextBuilder::VERSION)
+        };
 
-        return structure.str();
+        std::string summary;
+        cache_hit = doc_cache->get(key, summary);
+        if (cache_hit) return summary;
+
+        std::string system_prompt = PromptTemplates::getSummarizerSystemPrompt();
+        int budget = promptBudget(PromptTemplates::buildModuleSummaryPrompt(module_name, "", ""),
+                                  system_prompt, MODULE_SUMMARY_TOKENS);
+        PackedContext packed = ContextPacker::pack(module_data, module_context, budget);
+
+        summary = llm_service->generate(
+            PromptTemplates::buildModuleSummaryPrompt(module_name, packed.file_structure, packed.key_files_summary),
+            system_prompt, MODULE_SUMMARY_TOKENS);
+        doc_cache->put(repo_id + ":" + module_name, key, summary);
+        return summary;
     }
 
-    // Build key files summary with analysis
-    std::string buildKeyFilesSummary(const json& repo_data) {
-        std::ostringstream summary;
+    // Reduce step: merge a batch of rendered summaries, cached by their combined text
+    std::string mergeSummaries(const std::string& repo_id, const std::string& summaries) {
+        DocumentationCache::Key key{
+            ContentHash::sha256(summaries), "merged_summary", "", llm_service->getModel(),
+            std::to_string(PromptTemplates::VERSION)
+        };
 
-        if (!repo_data.contains("files")) {
-            return "No file analysis available.\n";
-        }
+        std::string merged;
+        if (doc_cache->get(key, merged)) return merged;
 
-        // Categorize files with expanded patterns
-        std::map<std::string, std::vector<std::pair<std::string, json>>> organized;
+        merged = llm_service->generate(PromptTemplates::buildMergeSummariesPrompt(summaries),
+                                       PromptTemplates::getSummarizerSystemPrompt(), MERGE_SUMMARY_TOKENS);
+        doc_cache->put(repo_id, key, merged);
+        return merged;
+    }
 
-        for (auto& [file_path, file_info] : repo_data["files"].items()) {
-            std::string file_summary = file_info.value("summary", "");
-            std::string filename = fs::path(file_path).filename().string();
-            std::string extension = fs::path(file_path).extension().string();
-            std::string directory = fs::path(file_path).parent_path().string();
-
-            std::string lower_summary = file_summary;
-            std::transform(lower_summary.begin(), lower_summary.end(),
-                         lower_summary.begin(), ::tolower);
-
-            std::string lower_filename = filename;
-            std::transform(lower_filename.begin(), lower_filename.end(),
-                         lower_filename.begin(), ::tolower);
-
-            std::string lower_directory = directory;
-            std::transform(lower_directory.begin(), lower_directory.end(),
-                         lower_directory.begin(), ::tolower);
-
-            // Enhanced categorization logic
-            bool categorized = false;
-
-            // Entry points
-            if (!categorized && (
-                lower_summary.find("entry point") != std::string::npos ||
-                lower_summary.find("main application") != std::string::npos ||
-                filename == "main.py" || filename == "app.py" ||
-                filename == "index.js" || filename == "main.cpp" ||
-                filename == "main.java" || filename == "server.js" ||
-                filename == "index.ts" || filename == "main.go")) {
-                organized["Entry Points"].push_back({file_path, file_info});
-                categorized = true;
-            }
+    static std::string renderSummaries(const std::vector<std::pair<std::string, std::string>>& summaries) {
+        std::ostringstream rendered;
+        for (const auto& [title, text] : summaries) {
+            rendered << "### " << title << "\n\n" << text << "\n\n";
+        }
+        return rendered.str();
+    }
 
-            // Models and Data Structures
-            if (!categorized && (
-                lower_summary.find("model") != std::string::npos ||
-                lower_summary.find("schema") != std::string::npos ||
-                lower_summary.find("entity") != std::string::npos ||
-                lower_summary.find("data structure") != std::string::npos ||
-                lower_directory.find("model") != std::string::npos ||
-                lower_directory.find("entity") != std::string::npos ||
-                lower_directory.find("schema") != std::string::npos)) {
-                organized["Models & Data Structures"].push_back({file_path, file_info});
-                categorized = true;
+    // Summarize modules in parallel (map), merge summaries until they fit the final
+    // prompt (reduce), then generate the document from the merged module summaries
+    std::string generateMapReduce(
+        const std::string& repo_id,
+        const json& repo_data,
+        const json& context,
+        const std::string& mapped_type,
+        const std::string& audience,
+        const std::string& system_prompt,
+        const LLMService::TokenCallback& on_token = nullptr,
+        const std::atomic<bool>* cancelled = nullptr
+    ) {
+        auto checkCancelled = [cancelled]() {
+            if (cancelled && cancelled->load()) throw GenerationCancelled();
+        };
+        const json empty_files = json::object();
+        const json& files = repo_data.contains("files") ? repo_data["files"] : empty_files;
+        auto modules = partitionIntoModules(files);
+
+        std::cout << "🗺️  Map-reduce over " << modules.size() << " modules ("
+                  << map_reduce_concurrency << " concurrent LLM calls)" << std::endl;
+
+        // Map
+        std::vector<std::pair<std::string, std::string>> summaries(modules.size());
+        std::atomic<size_t> reused{0};
+        parallelFor(modules.size(), map_reduce_concurrency, [&](size_t i) {
+            checkCancelled();
+            bool cache_hit = false;
+            summaries[i] = {modules[i].first, summarizeModule(repo_id, modules[i].first, modules[i].second, cache_hit)};
+            if (cache_hit) reused++;
+        });
+        std::cout << "✓ Module summaries: " << modules.size() - reused << " generated, "
+                  << reused << " reused from cache" << std::endl;
+
+        // Reduce until the summaries fit next to the overview and a minimal structure
+        std::string overview = context["overview"];
+        int final_budget = promptBudget(PromptTemplates::buildPrompt(mapped_type, audience, "", "", ""),
+                                        system_prompt, llm_service->getModelConfig().num_predict);
+        int summaries_budget = (final_budget - final_budget / 10 - ContextPacker::estimateTokens(overview)) * 3 / 4;
+        int merge_budget = promptBudget(PromptTemplates::buildMergeSummariesPrompt(""),
+                                        PromptTemplates::getSummarizerSystemPrompt(), MERGE_SUMMARY_TOKENS) * 9 / 10;
+
+        for (int round = 1; summaries.size() > 1 &&
+                            ContextPacker::estimateTokens(renderSummaries(summaries)) > summaries_budget; ++round) {
+            // Greedy consecutive batches; at least two summaries each so every round shrinks the list
+            std::vector<std::vector<std::pair<std::string, std::string>>> batches;
+            int batch_tokens = 0;
+            for (const auto& summary : summaries) {
+                int tokens = ContextPacker::estimateTokens(renderSummaries({summary}));
+                if (batches.empty() || (batches.back().size() >= 2 && batch_tokens + tokens > merge_budget)) {
+                    batches.emplace_back();
+                    batch_tokens = 0;
+                }
+                batches.back().push_back(summary);
+                batch_tokens += tokens;
             }
 
-            // Services and Business Logic
-            if (!categorized && (
-                lower_summary.find("service") != std::string::npos ||
-                lower_summary.find("business logic") != std::string::npos ||
-                lower_summary.find("handler") != std::string::npos ||
-                lower_directory.find("service") != std::string::npos ||
-                lower_filename.find("service") != std::string::npos)) {
-                organized["Services & Business Logic"].push_back({file_path, file_info});
-                categorized = true;
-            }
+            std::vector<std::pair<std::string, std::string>> merged(batches.size());
+            parallelFor(batches.size(), map_reduce_concurrency, [&](size_t i) {
+                checkCancelled();
+                std::string title = batches[i].front().first;
+                if (batches[i].size() > 1) {
+                    title += " ... " + batches[i].back().first;
+                    merged[i] = {title, mergeSummaries(repo_id, renderSummaries(batches[i]))};
+                } else {
+                    merged[i] = batches[i].front();
+                }
+            });
 
-            // API Routes and Controllers
-            if (!categorized && (
-                lower_summary.find("controller") != std::string::npos ||
-                lower_summary.find("route") != std::string::npos ||
-                lower_summary.find("api") != std::string::npos ||
-                lower_summary.find("endpoint") != std::string::npos ||
-                lower_directory.find("route") != std::string::npos ||
-                lower_directory.find("controller") != std::string::npos ||
-                lower_directory.find("api") != std::string::npos)) {
-                organized["API Routes & Controllers"].push_back({file_path, file_info});
-                categorized = true;
-            }
+            std::cout << "🔻 Reduce round " << round << ": " << summaries.size() << " → "
+                      << merged.size() << " summaries" << std::endl;
+            summaries = std::move(merged);
+        }
 
-            // Algorithms and Computational Logic
-            if (!categorized && (
-                lower_summary.find("algorithm") != std::string::npos ||
-                lower_summary.find("computation") != std::string::npos ||
-                lower_summary.find("calculation") != std::string::npos ||
-                lower_directory.find("algorithm") != std::string::npos ||
-                lower_directory.find("compute") != std::string::npos)) {
-                organized["Algorithms & Computations"].push_back({file_path, file_info});
-                categorized = true;
-            }
+        // Final document over the module summaries
+        std::string module_summaries = renderSummaries(summaries);
+        std::string structure_mode;
+        std::string file_structure = ContextPacker::packStructure(
+            context["file_structure"], files,
+            final_budget - final_budget / 10 - ContextPacker::estimateTokens(overview) -
+                ContextPacker::estimateTokens(module_summaries),
+            structure_mode);
 
-            // Utilities and Helpers
-            if (!categorized && (
-                lower_summary.find("utility") != std::string::npos ||
-                lower_summary.find("helper") != std::string::npos ||
-                lower_summary.find("util") != std::string::npos ||
-                lower_directory.find("util") != std::string::npos ||
-                lower_directory.find("helper") != std::string::npos ||
-                lower_filename.find("util") != std::string::npos)) {
-                organized["Utilities & Helpers"].push_back({file_path, file_info});
-                categorized = true;
-            }
+        std::string prompt = PromptTemplates::buildPrompt(mapped_type, audience, overview, file_structure, module_summaries);
 
-            // Configuration
-            if (!categorized && (
-                lower_summary.find("config") != std::string::npos ||
-                lower_filename.find("config") != std::string::npos ||
-                extension == ".env" || extension == ".yml" ||
-                extension == ".yaml" || extension == ".toml" ||
-                filename == "docker-compose.yml" || filename == "Dockerfile")) {
-                organized["Configuration"].push_back({file_path, file_info});
-                categorized = true;
-            }
+        std::cout << "🤖 Generating final documentation from " << summaries.size() << " module summaries..." << std::endl;
+        if (on_token) {
+            return llm_service->generateStream(prompt, system_prompt, on_token, cancelled);
+        }
+        return llm_service->generate(prompt, system_prompt);
+    }
 
-            // Tests
-            if (!categorized && (
-                lower_summary.find("test") != std::string::npos ||
-                lower_directory.find("test") != std::string::npos ||
-                lower_filename.find("test") != std::string::npos ||
-                lower_filename.find("spec") != std::string::npos)) {
-                organized["Tests"].push_back({file_path, file_info});
-                categorized = true;
-            }
+    // Files that feed one section's prompt: the component categories its title is about
+    // (FileCategorizer::sectionCategories) or, for overview-style sections and categories
+    // the repository doesn't have, the whole repository. input_hash covers the scope and
+    // the fingerprint of every input file, so it changes exactly when the prompt would.
+    struct SectionInputs {
+        std::vector<std::string> scope;     // empty: the whole repository
+        std::vector<std::string> paths;
+        std::string input_hash;
+    };
+
+    static std::vector<SectionInputs> resolveSectionInputs(
+        const json& files,
+        const json& context,
+        const std::map<std::string, std::string>& fingerprints,
+        const std::vector<PromptTemplates::DocumentSection>& sections
+    ) {
+        std::map<std::string, std::vector<std::string>> categories;
+        if (context.contains("categories")) {
+            categories = context["categories"].get<std::map<std::string, std::vector<std::string>>>();
+        } else {
+            categories = ContextBuilder::categorizeFiles(files);
+        }
 
-            // Data Processing and Pipeline
-            if (!categorized && (
-                lower_summary.find("pipeline") != std::string::npos ||
-                lower_summary.find("processing") != std::string::npos ||
-                lower_summary.find("data processing") != std::string::npos ||
-                lower_directory.find("pipeline") != std::string::npos ||
-                lower_directory.find("data") != std::string::npos)) {
-                organized["Data Pipeline & Processing"].push_back({file_path, file_info});
-                categorized = true;
+        std::vector<SectionInputs> inputs;
+        for (const auto& section : sections) {
+            SectionInputs section_inputs;
+            for (const auto& category : FileCategorizer::sectionCategories(section.title)) {
+                auto it = categories.find(category);
+                if (it == categories.end()) continue;
+                section_inputs.scope.push_back(category);
+                for (const auto& path : it->second) {
+                    if (fingerprints.count(path)) section_inputs.paths.push_back(path);
+                }
             }
-
-            // If still not categorized, put in "Other Components"
-            if (!categorized) {
-                organized["Other Components"].push_back({file_path, file_info});
+            if (section_inputs.paths.empty()) {
+                section_inputs.scope.clear();
+                for (const auto& [path, _] : fingerprints) section_inputs.paths.push_back(path);
             }
-        }
+            std::sort(section_inputs.paths.begin(), section_inputs.paths.end());
 
-        // Build summary for each category
-        int total_files_documented = 0;
-        for (const auto& [category, files] : organized) {
-            if (files.empty()) continue;
+            std::string material;
+            for (const auto& category : section_inputs.scope) material += category + "\n";
+            for (const auto& path : section_inputs.paths) material += path + " " + fingerprints.at(path) + "\n";
+            section_inputs.input_hash = ContentHash::sha256(material);
+            inputs.push_back(std::move(section_inputs));
+        }
+        return inputs;
+    }
 
-            summary << "### " << category << "\n\n";
+    // Generate each "## " section of the doc type's outline as its own request, up to
+    // section_concurrency at a time, and stitch them in outline order under one document
+    // title. Finished sections are streamed as soon as every section before them is done.
+    //
+    // The files behind each section, and the section's text, are recorded in the document's
+    // manifest, which lives outside the cache's LRU budget. A regeneration diffs the repository
+    // against that manifest and re-prompts only the sections whose inputs changed (all of them
+    // with force); the others are reused from the manifest as they are. Sections are also
+    // cached by the hash of their own inputs, so returning to an earlier state of the
+    // repository can still reuse what was generated for it then.
+    std::string generateSections(
+        const std::string& repo_id,
+        const json& repo_data,
+        const json& context,
+        const PackedContext& packed,
+        const std::string& mapped_type,
+        const std::string& audience,
+        const std::string& system_prompt,
+        const std::vector<PromptTemplates::DocumentSection>& sections,
+        bool force,
+        const LLMService::TokenCallback& on_token = nullptr,
+        const std::atomic<bool>* cancelled = nullptr
+    ) {
+        std::string title = PromptTemplates::getDocumentTitle(mapped_type, audience);
+        if (title.empty()) title = formatDocTypeForDisplay(mapped_type);
+
+        // Output shared between the sections, but never so little that a section is cut short
+        int section_tokens = std::max(MIN_SECTION_TOKENS, llm_service->getModelConfig().num_predict * 2 /
+                                                              static_cast<int>(sections.size()));
+        std::string repository_prefix = PromptTemplates::buildContextPrefix(packed.overview, packed.file_structure,
+                                                                            packed.key_files_summary);
+
+        const json empty_files = json::object();
+        const json& files = repo_data.contains("files") ? repo_data["files"] : empty_files;
+        std::map<std::string, std::string> fingerprints;
+        for (auto& [file_path, file_info] : files.items()) {
+            fingerprints[file_path] = ContentHash::sha256(file_info.dump());
+        }
+        auto inputs = resolveSectionInputs(files, context, fingerprints, sections);
+
+        std::string section_version = std::to_string(PromptTemplates::VERSION) + "." +
+                                      std::to_string(ContextBuilder::VERSION) + "/" + std::to_string(section_tokens);
+        auto sectionKey = [&](size_t i) {
+            return DocumentationCache::Key{
+                inputs[i].input_hash,
+                mapped_type + "#section:" + sections[i].title,
+                audience,
+                llm_service->getModel(),
+                section_version
+            };
+        };
 
-            for (const auto& [file_path, file_info] : files) {
-                summary << "**" << file_path << "**\n";
+        // Files added, removed or modified since the previous generation of this document
+        json previous;
+        bool has_previous = doc_cache->getManifest(repo_id, mapped_type, audience, previous) &&
+                            previous.contains("files");
+        std::map<std::string, const json*> previous_sections;
+        if (has_previous && previous.contains("sections")) {
+            for (const auto& before : previous["sections"]) {
+                previous_sections[before.value("title", "")] = &before;
+            }
+        }
+        std::set<std::string> changed;
+        if (has_previous) {
+            const json& before = previous["files"];
+            for (const auto& [file_path, fingerprint] : fingerprints) {
+                if (!before.contains(file_path) || before[file_path] != fingerprint) changed.insert(file_path);
+            }
+            for (auto& [file_path, _] : before.items()) {
+                if (!fingerprints.count(file_path)) changed.insert(file_path);
+            }
+        }
 
-                // Add summary if available
-                std::string file_summary_text = file_info.value("summary", "");
-                if (!file_summary_text.empty()) {
-                    summary << "- Summary: " << file_summary_text << "\n";
+        std::vector<std::string> results(sections.size());
+        std::vector<bool> finished(sections.size(), false);
+        std::vector<std::vector<std::string>> changed_inputs(sections.size());
+        std::vector<std::string> stale_reasons(sections.size());
+        std::vector<size_t> stale;
+        size_t from_manifest = 0;
+        for (size_t i = 0; i < sections.size(); ++i) {
+            for (const auto& file_path : inputs[i].paths) {
+                if (changed.count(file_path)) changed_inputs[i].push_back(file_path);
+            }
+            // Removed files are inputs of the sections they used to feed
+            auto before_it = previous_sections.find(sections[i].title);
+            const json* before = before_it != previous_sections.end() ? before_it->second : nullptr;
+            if (before) {
+                std::vector<std::string> before_paths;
+                if (before->value("whole_repository", false)) {
+                    for (auto& [file_path, _] : previous["files"].items()) before_paths.push_back(file_path);
                 } else {
-                    summary << "- Summary: Code file (no detailed summary available)\n";
+                    before_paths = before->value("files", std::vector<std::string>{});
+                }
+                for (const auto& file_path : before_paths) {
+                    if (!fingerprints.count(file_path)) changed_inputs[i].push_back(file_path);
                 }
+            }
 
-                // Add analysis details if available
-                if (file_info.contains("analysis")) {
-                    const auto& analysis = file_info["analysis"];
+            // Unchanged inputs keep the manifest's text, as long as it was generated the same
+            // way (model, templates, token budget) and from the same material
+            if (force) {
+                stale_reasons[i] = "forced";
+            } else if (changed_inputs[i].empty() && before && before->contains("text") &&
+                       previous.value("model", "") == llm_service->getModel() &&
+                       before->value("version", "") == section_version &&
+                       before->value("input_hash", "") == inputs[i].input_hash) {
+                results[i] = (*before)["text"].get<std::string>();
+                finished[i] = true;
+                from_manifest++;
+                continue;
+            } else if (doc_cache->get(sectionKey(i), results[i])) {
+                finished[i] = true;
+                continue;
+            } else if (!changed_inputs[i].empty()) {
+                stale_reasons[i] = std::to_string(changed_inputs[i].size()) + " input files changed";
+            } else {
+                stale_reasons[i] = before ? "generated differently" : "not generated before";
+            }
+            stale.push_back(i);
+        }
 
-                    // File type and lines
-                    if (analysis.contains("type") || analysis.contains("lines")) {
-                        summary << "- Type: " << analysis.value("type", "unknown")
-                               << " (" << analysis.value("lines", 0) << " lines)\n";
-                    }
+        if (has_previous) {
+            std::cout << "🔍 " << changed.size() << " files changed since the last " << mapped_type
+                      << " generation" << std::endl;
+        }
+        std::cout << "🧩 Sections of " << mapped_type << ": " << sections.size() - stale.size() << " reused ("
+                  << from_manifest << " from the manifest), " << stale.size() << " to generate ("
+                  << section_concurrency << " concurrent, up to " << section_tokens << " tokens each)" << std::endl;
+        for (size_t i : stale) {
+            std::cout << "   ↻ " << sections[i].title << ": " << stale_reasons[i]
+                      << (inputs[i].scope.empty() ? " (whole repository)" : "") << std::endl;
+        }
 
-                    // Functions
-                    if (analysis.contains("functions") && !analysis["functions"].empty()) {
-                        summary << "- Key Functions: ";
-                        int count = 0;
-                        for (const auto& func : analysis["functions"]) {
-                            if (count++ >= 5) {
-                                summary << "...";
-                                break;
-                            }
-                            summary << "`" << func.get<std::string>() << "`";
-                            if (count < analysis["functions"].size() && count < 5) {
-                                summary << ", ";
-                            }
-                        }
-                        summary << "\n";
-                    }
+        std::mutex stream_mutex;
+        size_t next_to_stream = 0;
+        std::atomic<bool> stream_stopped{false};
 
-                    // Classes
-                    if (analysis.contains("classes") && !analysis["classes"].empty()) {
-                        summary << "- Classes: ";
-                        int count = 0;
-                        for (const auto& cls : analysis["classes"]) {
-                            if (count++ >= 5) {
-                                summary << "...";
-                                break;
-                            }
-                            summary << "`" << cls.get<std::string>() << "`";
-                            if (count < analysis["classes"].size() && count < 5) {
-                                summary << ", ";
-                            }
-                        }
-                        summary << "\n";
-                    }
+        auto emit = [&](const std::string& chunk) {
+            if (on_token && !stream_stopped && !on_token(chunk)) stream_stopped = true;
+        };
+        auto emitFinished = [&]() {
+            while (next_to_stream < sections.size() && finished[next_to_stream]) {
+                emit(results[next_to_stream++]);
+            }
+        };
+        if (on_token) {
+            std::lock_guard<std::mutex> lock(stream_mutex);
+            emit("# " + title + "\n\n");
+            emitFinished();
+        }
 
-                    // Imports/Dependencies
-                    if (analysis.contains("imports") && !analysis["imports"].empty()) {
-                        summary << "- Dependencies: ";
-                        int count = 0;
-                        for (const auto& imp : analysis["imports"]) {
-                            if (count++ >= 3) {
-                                summary << "...";
-                                break;
-                            }
-                            summary << "`" << imp.get<std::string>() << "`";
-                            if (count < analysis["imports"].size() && count < 3) {
-                                summary << ", ";
-                            }
-                        }
-                        summary << "\n";
-                    }
-                }
+        parallelFor(stale.size(), section_concurrency, [&](size_t k) {
+            if ((cancelled && cancelled->load()) || stream_stopped) throw GenerationCancelled();
+            size_t i = stale[k];
+
+            std::string suffix = PromptTemplates::buildSectionSuffix(mapped_type, audience, title, sections[i],
+                                                                     sections, inputs[i].scope);
+            std::string prefix = repository_prefix;
+            if (!inputs[i].scope.empty()) {
+                // Pack just the section's files into the room its own prompt leaves
+                json scoped_data;
+                scoped_data["files"] = json::object();
+                for (const auto& file_path : inputs[i].paths) scoped_data["files"][file_path] = files[file_path];
+                scoped_data["analyzed_files"] = inputs[i].paths.size();
+                json scoped_context = ContextBuilder::buildContext(scoped_data);
+
+                int budget = promptBudget(PromptTemplates::buildContextPrefix("", "", "") + suffix,
+                                          system_prompt, section_tokens);
+                PackedContext scoped = ContextPacker::pack(scoped_data, scoped_context, budget);
+                prefix = PromptTemplates::buildContextPrefix(scoped.overview, scoped.file_structure,
+                                                             scoped.key_files_summary);
+            }
 
-                summary << "\n";
-                total_files_documented++;
+            std::string prompt = prefix + suffix;
+            std::string text = cancelled
+                ? llm_service->generateStream(prompt, system_prompt, [](const std::string&) { return true; },
+                                              cancelled, section_tokens)
+                : llm_service->generate(prompt, system_prompt, section_tokens);
+
+            // Every section starts with its outline heading, whatever title lines the model wrote
+            auto skipBlank = [&text]() {
+                size_t start = text.find_first_not_of(" \t\r\n");
+                text = start == std::string::npos ? "" : text.substr(start);
+            };
+            skipBlank();
+            while (text.rfind("# ", 0) == 0 || text.rfind("## ", 0) == 0) {
+                size_t line_end = text.find('\n');
+                text = line_end == std::string::npos ? "" : text.substr(line_end + 1);
+                skipBlank();
+            }
+            text = "## " + sections[i].title + "\n\n" + text;
+            while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) text.pop_back();
+            text += "\n\n";
+
+            // A finished section is reusable even if the rest of the document is cancelled
+            doc_cache->put(repo_id, sectionKey(i), text);
+
+            std::lock_guard<std::mutex> lock(stream_mutex);
+            results[i] = std::move(text);
+            finished[i] = true;
+            emitFinished();
+        });
+
+        if (stream_stopped) throw GenerationCancelled();
+
+        // Record what fed each section, and what it produced, for the next regeneration
+        json manifest;
+        manifest["repo_id"] = repo_id;
+        manifest["doc_type"] = mapped_type;
+        manifest["audience"] = audience;
+        manifest["model"] = llm_service->getModel();
+        manifest["generated"] = getCurrentTimestamp();
+        manifest["files"] = fingerprints;
+        manifest["sections"] = json::array();
+        std::set<size_t> regenerated(stale.begin(), stale.end());
+        for (size_t i = 0; i < sections.size(); ++i) {
+            json entry;
+            entry["title"] = sections[i].title;
+            entry["input_hash"] = inputs[i].input_hash;
+            entry["whole_repository"] = inputs[i].scope.empty();
+            entry["scope"] = inputs[i].scope;
+            if (!inputs[i].scope.empty()) {
+                std::set<std::string> directories;
+                for (const auto& file_path : inputs[i].paths) {
+                    std::string dir = fs::path(file_path).parent_path().string();
+                    directories.insert(dir.empty() ? "." : dir);
+                }
+                entry["directories"] = directories;
+                entry["files"] = inputs[i].paths;
             }
+            entry["version"] = section_version;
+            entry["regenerated"] = regenerated.count(i) > 0;
+            entry["changed_inputs"] = changed_inputs[i];
+            entry["text"] = results[i];
+            manifest["sections"].push_back(entry);
         }
+        doc_cache->putManifest(repo_id, mapped_type, audience, manifest);
 
-        // If no files were categorized, return a helpful message
-        if (total_files_documented == 0) {
-            return "**Note:** No key components were identified in the repository analysis. "
-                   "This may indicate that the repository scanning did not capture file summaries, "
-                   "or the files don't match common component patterns.\n\n";
-        }
+        std::cout << "✓ " << mapped_type << ": regenerated " << stale.size() << " of " << sections.size()
+                  << " sections" << std::endl;
+
+        std::string document = "# " + title + "\n\n";
+        for (const auto& section : results) document += section;
+        return document;
+    }
+
+    // Metadata header and disclaimer footer around generated documentation
+    std::string documentHeader(const std::string& mapped_type, const std::string& audience, const std::string& repo_id) {
+        std::ostringstream header;
+        header << "# Documentation\n\n";
+        header << "**Generated:** " << getCurrentTimestamp() << "\n";
+        header << "**Type:** " << mapped_type << "\n";
+        header << "**Audience:** " << audience << "\n";
+        header << "**Repository:** " << repo_id << "\n\n";
+        header << "---\n\n";
+        return header.str();
+    }
+
+    static std::string documentFooter() {
+        return "\n\n---\n\n"
+               "*This documentation was generated using AI assistance. "
+               "For formal regulatory submissions, please have this reviewed and "
+               "verified by appropriate personnel.*\n";
+    }
 
-        return summary.str();
+    std::string wrapDocumentation(
+        const std::string& documentation,
+        const std::string& mapped_type,
+        const std::string& audience,
+        const std::string& repo_id
+    ) {
+        return documentHeader(mapped_type, audience, repo_id) + documentation + documentFooter();
     }
 
     // Map doc types from frontend to internal categories
@@ -375,79 +689,329 @@ public:
 
         // Initialize LLM service
         llm_service = std::make_shared<LLMService>();
+        doc_cache = std::make_shared<DocumentationCache>();
+        embedding_service = std::make_shared<EmbeddingService>(llm_service);
+
+        const char* generation_mode = std::getenv("DOC_GENERATION_MODE");
+        default_generation_mode = generation_mode && isValidGenerationMode(generation_mode) ? generation_mode : "single";
+
+        const char* keep_alive = std::getenv("DOC_BATCH_KEEP_ALIVE");
+        batch_keep_alive = keep_alive ? keep_alive : "10m";
+
+        const char* concurrency = std::getenv("MAP_REDUCE_CONCURRENCY");
+        map_reduce_concurrency = concurrency ? std::max(1, std::atoi(concurrency)) : 2;
+
+        const char* sections = std::getenv("SECTION_CONCURRENCY");
+        section_concurrency = sections ? std::max(1, std::atoi(sections)) : 4;
+
+        const char* max_modules = std::getenv("MAP_REDUCE_MAX_MODULES");
+        map_reduce_max_modules = max_modules ? std::max(2, std::atoi(max_modules)) : 32;
 
         std::cout << "✓ Documentation service initialized with LLM support" << std::endl;
 
-        // Check LLM health
-        if (!llm_service->checkHealth()) {
+        // LLMService probed Ollama at startup
+        if (!llm_service->isAvailable()) {
             std::cerr << "⚠️  Warning: LLM service not available. Will use fallback generation." << std::endl;
         }
     }
 
-    // Generate documentation using LLM
+    // Generate documentation using LLM. Output for unchanged repository content is served
+    // from the documentation cache unless force is set. mode is "single" (one prompt over
+    // the packed context), "map_reduce" (per-module summaries combined into the final
+    // prompt), "auto" (map-reduce only when the context doesn't fit) or "sections" (each
+    // outline section generated concurrently, then stitched); empty uses DOC_GENERATION_MODE.
+    //
+    // With on_chunk set the document is also delivered incrementally: the header with the
+    // first LLM token, then each token, then the footer (cached and fallback documents
+    // arrive as one chunk). Returning false from on_chunk or setting `cancelled` stops the
+    // generation with GenerationCancelled; partial output is never cached.
     std::string generateDocumentation(
         const std::string& repo_id,
         const std::string& doc_type,
-        const std::string& audience = "developers"
+        const std::string& audience = "developers",
+        const std::string& mode = "",
+        bool force = false,
+        bool* from_cache = nullptr,
+        const LLMService::TokenCallback& on_chunk = nullptr,
+        const std::atomic<bool>* cancelled = nullptr
     ) {
         std::cout << "📝 Generating " << doc_type << " documentation for repo: " << repo_id << std::endl;
+        if (from_cache) *from_cache = false;
 
         // Load repository data
-        json repo_data = loadRepositoryData(repo_id);
+        auto repo_data_ptr = loadRepositoryData(repo_id);
+        const json& repo_data = *repo_data_ptr;
 
         // Map doc type
         std::string mapped_type = mapDocumentationType(doc_type);
 
-        // Check if LLM is available
-        if (!llm_service->checkHealth()) {
+        // Context precomputed at scan time (built here only for older summaries)
+        json context = ContextBuilder::getContext(repo_data);
+
+        // Get system prompt
+        std::string system_prompt = PromptTemplates::getSystemPrompt(mapped_type);
+
+        // Auto mode map-reduces when not every key file fits. Retrieval only reorders the files,
+        // so a plain pack settles the mode (and the cache key) without an embedding call
+        std::string requested_mode = mode.empty() ? default_generation_mode : mode;
+        bool use_map_reduce = requested_mode == "map_reduce";
+        PackedContext fit;
+        if (requested_mode == "auto") {
+            fit = ContextPacker::pack(repo_data, context, contextBudget(mapped_type, audience, system_prompt));
+            use_map_reduce = fit.key_files_detailed < fit.key_files_total;
+        }
+
+        // Section mode needs an outline to split; doc types without one generate in a single pass
+        std::vector<PromptTemplates::DocumentSection> sections;
+        if (requested_mode == "sections") {
+            sections = PromptTemplates::getDocumentSections(mapped_type, audience);
+        }
+        bool use_sections = sections.size() > 1;
+
+        DocumentationCache::Key cache_key{
+            context["content_hash"],
+            use_map_reduce ? mapped_type + "#map_reduce" : use_sections ? mapped_type + "#sections" : mapped_type,
+            audience,
+            llm_service->getModel(),
+            std::to_string(PromptTemplates::VERSION) + "." + std::to_string(ContextBuilder::VERSION)
+        };
+
+        // Deliver a complete document to a streaming caller in one piece
+        auto deliver = [&](const std::string& document) {
+            if (on_chunk && !on_chunk(document)) throw GenerationCancelled();
+            return document;
+        };
+
+        std::string cached;
+        if (!force && doc_cache->get(cache_key, cached)) {
+            std::cout << "⚡ Serving cached " << mapped_type << " documentation for repo: " << repo_id << std::endl;
+            if (from_cache) *from_cache = true;
+            return deliver(cached);
+        }
+
+        // Cached breaker state; an unreachable Ollama costs no round trip here
+        if (!llm_service->isAvailable()) {
             std::cerr << "⚠️  LLM not available, using fallback generation" << std::endl;
-            return generateFallbackDocumentation(repo_data, mapped_type, audience);
+            return deliver(generateFallbackDocumentation(repo_data, mapped_type, audience));
+        }
+
+        // Fit the context into the model's window so Ollama never truncates the prompt;
+        // map-reduce packs each module separately
+        PackedContext packed;
+        if (!use_map_reduce) {
+            packed = packContext(repo_id, repo_data, context, mapped_type, audience, system_prompt,
+                                 requested_mode == "auto" ? &fit : nullptr);
+        }
+
+        // Streaming: the header goes out with the first token, so time to first byte is the prefill time
+        std::string header = documentHeader(mapped_type, audience, repo_id);
+        bool streamed = false;
+        LLMService::TokenCallback forward = nullptr;
+        if (on_chunk) {
+            forward = [&](const std::string& token) {
+                if (!streamed) {
+                    streamed = true;
+                    if (!on_chunk(header)) return false;
+                }
+                return on_chunk(token);
+            };
         }
 
         try {
-            // Build context from repository data
-            std::string repo_overview = buildRepositoryOverview(repo_data);
-            std::string file_structure = buildFileStructure(repo_data);
-            std::string key_files_summary = buildKeyFilesSummary(repo_data);
-
-            // Build prompt
-            std::string prompt = PromptTemplates::buildPrompt(
-                mapped_type,
-                audience,
-                repo_overview,
-                file_structure,
-                key_files_summary
-            );
-
-            // Get system prompt
-            std::string system_prompt = PromptTemplates::getSystemPrompt(mapped_type);
-
-            std::cout << "🤖 Generating documentation with LLM (this may take 30-60 seconds)..." << std::endl;
-
-            // Generate with LLM
-            std::string documentation = llm_service->generate(prompt, system_prompt);
-
-            // Add header with metadata
-            std::ostringstream final_doc;
-            final_doc << "# Documentation\n\n";
-            final_doc << "**Generated:** " << getCurrentTimestamp() << "\n";
-            final_doc << "**Type:** " << mapped_type << "\n";
-            final_doc << "**Audience:** " << audience << "\n";
-            final_doc << "**Repository:** " << repo_id << "\n\n";
-            final_doc << "---\n\n";
-            final_doc << documentation << "\n\n";
-            final_doc << "---\n\n";
-            final_doc << "*This documentation was generated using AI assistance. "
-                      << "For formal regulatory submissions, please have this reviewed and "
-                      << "verified by appropriate personnel.*\n";
-
-            return final_doc.str();
+            std::string documentation;
+            if (use_map_reduce) {
+                documentation = generateMapReduce(repo_id, repo_data, context, mapped_type, audience, system_prompt,
+                                                  forward, cancelled);
+            } else if (use_sections) {
+                documentation = generateSections(repo_id, repo_data, context, packed, mapped_type, audience,
+                                                 system_prompt, sections, force, forward, cancelled);
+            } else {
+                // Build prompt
+                std::string prompt = PromptTemplates::buildPrompt(
+                    mapped_type,
+                    audience,
+                    packed.overview,
+                    packed.file_structure,
+                    packed.key_files_summary
+                );
+
+                std::cout << "🤖 Generating documentation with LLM (this may take 30-60 seconds)..." << std::endl;
+
+                // Generate with LLM
+                documentation = forward ? llm_service->generateStream(prompt, system_prompt, forward, cancelled)
+                                        : llm_service->generate(prompt, system_prompt);
+            }
+
+            if (on_chunk) {
+                if (!streamed && !on_chunk(header)) throw GenerationCancelled();
+                if (!on_chunk(documentFooter())) throw GenerationCancelled();
+            }
+            std::string final_doc = header + documentation + documentFooter();
 
+            // Only LLM output is cached; fallback docs are cheap and should be retried once the LLM is back
+            doc_cache->put(repo_id, cache_key, final_doc);
+
+            return final_doc;
+
+        } catch (const GenerationCancelled&) {
+            std::cout << "⏹️  Generation of " << mapped_type << " for " << repo_id << " cancelled" << std::endl;
+            throw;
         } catch (const std::exception& e) {
             std::cerr << "❌ LLM generation failed: " << e.what() << std::endl;
+            if (streamed) {
+                // Part of the document is already with the client; a fallback can't replace it
+                throw;
+            }
             std::cerr << "⚠️  Falling back to basic generation" << std::endl;
-            return generateFallbackDocumentation(repo_data, mapped_type, audience);
+            return deliver(generateFallbackDocumentation(repo_data, mapped_type, audience));
+        }
+    }
+
+    // Generate several documents over one repository. The context is loaded and packed once
+    // and every prompt starts with the same system prompt and repository prefix, so after the
+    // first item Ollama reuses the prefix from its KV cache and only evaluates the short
+    // task suffix. Items run one at a time (parallel requests would land in separate
+    // server slots without the shared prefix) and keep_alive holds the model between them.
+    // Setting `cancelled` stops the batch with GenerationCancelled before the next item.
+    json generateBatch(
+        const std::string& repo_id,
+        const std::vector<std::pair<std::string, std::string>>& items,
+        bool force = false,
+        const std::atomic<bool>* cancelled = nullptr
+    ) {
+        auto batch_start = std::chrono::steady_clock::now();
+        auto elapsedMs = [](std::chrono::steady_clock::time_point since) {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - since).count();
+        };
+
+        std::cout << "📚 Generating batch of " << items.size() << " documents for repo: " << repo_id << std::endl;
+
+        auto repo_data_ptr = loadRepositoryData(repo_id);
+        const json& repo_data = *repo_data_ptr;
+        json context = ContextBuilder::getContext(repo_data);
+
+        // The doc-type guidance moves into each task suffix so the system prompt is shared too
+        std::string system_prompt = PromptTemplates::getSystemPrompt("");
+        ModelConfig model_config = llm_service->getModelConfig();
+
+        // One packing for all items, sized for the longest task suffix
+        int budget = model_config.context_length;
+        for (const auto& [doc_type, audience] : items) {
+            std::string fixed_prompt = PromptTemplates::buildContextPrefix("", "", "") +
+                PromptTemplates::buildTaskSuffix(mapDocumentationType(doc_type), audience, true);
+            budget = std::min(budget, promptBudget(fixed_prompt, system_prompt, model_config.num_predict));
+        }
+        PackedContext packed = ContextPacker::pack(repo_data, context, budget);
+        std::string prefix = PromptTemplates::buildContextPrefix(packed.overview, packed.file_structure,
+                                                                 packed.key_files_summary);
+        long long context_ms = elapsedMs(batch_start);
+
+        std::cout << "📦 Shared prefix: ~" << ContextPacker::estimateTokens(prefix) << " tokens (structure: "
+                  << packed.structure_mode << ", key files: " << packed.key_files_detailed << "/"
+                  << packed.key_files_total << ")" << std::endl;
+
+        bool llm_available = llm_service->isAvailable();
+        if (!llm_available) {
+            std::cerr << "⚠️  LLM not available, using fallback generation for the batch" << std::endl;
+        }
+
+        json results = json::array();
+        size_t cached_count = 0;
+        size_t generated_count = 0;
+        for (const auto& [doc_type, audience] : items) {
+            if (cancelled && *cancelled) throw GenerationCancelled();
+            auto item_start = std::chrono::steady_clock::now();
+            std::string mapped_type = mapDocumentationType(doc_type);
+
+            DocumentationCache::Key cache_key{
+                context["content_hash"],
+                mapped_type + "#batch",
+                audience,
+                llm_service->getModel(),
+                std::to_string(PromptTemplates::VERSION) + "." + std::to_string(ContextBuilder::VERSION)
+            };
+
+            json item;
+            item["doc_type"] = doc_type;
+            item["audience"] = audience;
+            item["cached"] = false;
+            item["fallback"] = false;
+
+            std::string documentation;
+            if (!force && doc_cache->get(cache_key, documentation)) {
+                item["cached"] = true;
+                cached_count++;
+            } else if (!llm_available) {
+                documentation = generateFallbackDocumentation(repo_data, mapped_type, audience);
+                item["fallback"] = true;
+            } else {
+                try {
+                    std::cout << "🤖 [" << results.size() + 1 << "/" << items.size() << "] Generating "
+                              << mapped_type << " (" << audience << ")..." << std::endl;
+                    std::string prompt = prefix + PromptTemplates::buildTaskSuffix(mapped_type, audience, true);
+                    documentation = wrapDocumentation(llm_service->generate(prompt, system_prompt, 0, batch_keep_alive),
+                                                      mapped_type, audience, repo_id);
+                    doc_cache->put(repo_id, cache_key, documentation);
+                    generated_count++;
+                } catch (const std::exception& e) {
+                    std::cerr << "❌ LLM generation failed for " << mapped_type << ": " << e.what() << std::endl;
+                    documentation = generateFallbackDocumentation(repo_data, mapped_type, audience);
+                    item["fallback"] = true;
+                }
+            }
+
+            item["documentation"] = documentation;
+            item["duration_ms"] = elapsedMs(item_start);
+            results.push_back(item);
         }
+
+        json batch;
+        batch["repo_id"] = repo_id;
+        batch["documents"] = results;
+        batch["generated"] = generated_count;
+        batch["cached"] = cached_count;
+        batch["prefix_tokens"] = ContextPacker::estimateTokens(prefix);
+        batch["context_ms"] = context_ms;
+        batch["total_ms"] = elapsedMs(batch_start);
+
+        std::cout << "✅ Batch complete: " << generated_count << " generated, " << cached_count
+                  << " cached in " << batch["total_ms"].get<long long>() << " ms" << std::endl;
+        return batch;
+    }
+
+    // Frontend doc types: detailed (internal_*, external_*) or legacy (internal, external)
+    static bool isValidDocType(const std::string& doc_type) {
+        return doc_type == "internal" || doc_type == "external" ||
+               doc_type.rfind("internal_", 0) == 0 ||
+               doc_type.rfind("external_", 0) == 0;
+    }
+
+    static bool isValidGenerationMode(const std::string& mode) {
+        return mode == "single" || mode == "map_reduce" || mode == "auto" || mode == "sections";
+    }
+
+    // Documentation cache hit ratio and size
+    json getCacheStats() {
+        return doc_cache->getStats();
+    }
+
+    // Which files fed each section of the last sectioned generation of a document, and
+    // which sections that generation re-prompted. Section texts are left out.
+    json getSectionManifest(const std::string& repo_id, const std::string& doc_type, const std::string& audience) {
+        json manifest;
+        if (!doc_cache->getManifest(repo_id, mapDocumentationType(doc_type), audience, manifest)) {
+            throw std::runtime_error("No sectioned " + doc_type + " documentation generated for " + repo_id);
+        }
+        if (manifest.contains("sections")) {
+            for (auto& section : manifest["sections"]) section.erase("text");
+        }
+        return manifest;
+    }
+
+    // Embedding service shared with the scanner, which builds the vector files retrieval reads
+    std::shared_ptr<EmbeddingService> getEmbeddingService() const {
+        return embedding_service;
     }
 
     // Get LLM service (for accessing system info)
@@ -463,6 +1027,7 @@ private:
         const std::string& audience
     ) {
         std::ostringstream doc;
+        json context = ContextBuilder::getContext(repo_data);
 
         // Header with metadata
         doc << "# " << formatDocTypeForDisplay(doc_type) << "\n\n";
@@ -479,7 +1044,7 @@ private:
 
         // Repository Overview
         doc << "## Repository Overview\n\n";
-        doc << buildRepositoryOverview(repo_data) << "\n";
+        doc << context["overview"].get<std::string>() << "\n";
 
         // Technology Stack (inferred from file types)
         doc << "### Technology Stack\n\n";
@@ -488,10 +1053,10 @@ private:
         // Repository Structure
         doc << "## Repository Structure\n\n";
         doc << "The following shows the organization of files and directories in the repository:\n\n";
-        doc << buildFileStructure(repo_data) << "\n";
+        doc << context["file_structure"].get<std::string>() << "\n";
 
         // Key Components
-        std::string components_summary = buildKeyFilesSummary(repo_data);
+        std::string components_summary = context["key_files_summary"];
         doc << "## Key Components\n\n";
 
         if (components_summary.find("**Note:**") != std::string::npos) {
@@ -633,30 +1198,7 @@ private:
         insights << "Based on the directory structure:\n\n";
 
         for (const auto& dir : directories) {
-            std::string dir_lower = dir;
-            std::transform(dir_lower.begin(), dir_lower.end(), dir_lower.begin(), ::tolower);
-
-            insights << "- **" << dir << "**: ";
-
-            if (dir_lower.find("model") != std::string::npos) {
-                insights << "Data models and schemas\n";
-            } else if (dir_lower.find("service") != std::string::npos) {
-                insights << "Business logic and services\n";
-            } else if (dir_lower.find("api") != std::string::npos || dir_lower.find("route") != std::string::npos) {
-                insights << "API endpoints and routing\n";
-            } else if (dir_lower.find("util") != std::string::npos || dir_lower.find("helper") != std::string::npos) {
-                insights << "Utility functions and helpers\n";
-            } else if (dir_lower.find("test") != std::string::npos) {
-                insights << "Test files\n";
-            } else if (dir_lower.find("config") != std::string::npos) {
-                insights << "Configuration files\n";
-            } else if (dir_lower.find("pipeline") != std::string::npos || dir_lower.find("data") != std::string::npos) {
-                insights << "Data processing and pipeline components\n";
-            } else if (dir_lower.find("algorithm") != std::string::npos) {
-                insights << "Algorithms and computational logic\n";
-            } else {
-                insights << "Component files\n";
-            }
+            insights << "- **" << dir << "**: " << FileCategorizer::directoryRole(dir) << "\n";
         }
 
         insights << "\n";
@@ -0,0 +1,264 @@
+#ifndef EMBEDDING_SERVICE_H
+#define EMBEDDING_SERVICE_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <filesystem>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include "LLMService.h"
+#include "../utils/VectorIndex.h"
+#include "../utils/ContentHash.h"
+#include "../utils/ContextBuilder.h"
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+// Embedding-backed file retrieval. Once a scan is saved, a background worker
+// embeds every file's path, summary and symbol lists through Ollama in batches of
+// EMBED_BATCH_SIZE and writes the repository's vector file; at generation time a doc-type query
+// is embedded once and matched against it to pick the files the prompt should
+// carry in full. Everything here is best effort: without an embedding model the
+// index is simply absent and context selection keeps its category heuristics.
+class EmbeddingService {
+private:
+    struct LoadedIndex {
+        std::shared_ptr<const VectorIndex> index;
+        fs::file_time_type mtime;
+    };
+
+    std::shared_ptr<LLMService> llm_service;
+    std::string summaries_path;
+    size_t batch_size;
+    size_t top_k;
+    VectorIndex::Precision precision;
+    static constexpr size_t MAX_TEXT_CHARS = 4000;
+
+    std::mutex mutex;
+    std::map<std::string, LoadedIndex> loaded;                   // repo_id -> parsed vector file
+    std::map<std::string, std::vector<float>> query_vectors;     // model + query -> embedding
+
+    // Scans waiting to be indexed; a newer scan of a repository replaces its queued one
+    std::mutex queue_mutex;
+    std::condition_variable work_available;
+    std::map<std::string, json> pending;                         // repo_id -> scanned files
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+
+    std::string indexFile(const std::string& repo_id) const {
+        return summaries_path + "/" + repo_id + ".vec";
+    }
+
+    // What a file is embedded as: its path, summary and declared symbols
+    static std::string embeddingText(const std::string& file_path, const json& file_info) {
+        std::string text = file_path + "\n" + file_info.value("summary", "");
+        if (file_info.contains("analysis")) {
+            const auto& analysis = file_info["analysis"];
+            for (const auto& [field, label] : {std::pair<const char*, const char*>{"classes", "Classes:"},
+                                               std::pair<const char*, const char*>{"functions", "Functions:"}}) {
+                if (!analysis.contains(field) || analysis[field].empty()) continue;
+                text += std::string("\n") + label;
+                for (const auto& symbol : analysis[field]) {
+                    if (symbol.is_string()) text += " " + symbol.get<std::string>();
+                }
+            }
+        }
+        // Summaries are short; this only guards against pathological symbol lists
+        if (text.size() > MAX_TEXT_CHARS) text.resize(MAX_TEXT_CHARS);
+        return text;
+    }
+
+    // Parsed vector file of a repository, re-read when the file changes; null if none
+    std::shared_ptr<const VectorIndex> loadIndex(const std::string& repo_id) {
+        std::string file_path = indexFile(repo_id);
+        std::error_code ec;
+        auto mtime = fs::last_write_time(file_path, ec);
+        if (ec) return nullptr;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = loaded.find(repo_id);
+        if (it != loaded.end() && it->second.mtime == mtime) return it->second.index;
+
+        auto index = std::make_shared<const VectorIndex>(VectorIndex::load(file_path));
+        loaded[repo_id] = {index, mtime};
+        return index;
+    }
+
+    void workerLoop() {
+        while (true) {
+            std::string repo_id;
+            json files;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                work_available.wait(lock, [this] { return stopping || !pending.empty(); });
+                if (stopping) return;
+
+                auto next = pending.begin();
+                repo_id = next->first;
+                files = std::move(next->second);
+                pending.erase(next);
+            }
+
+            // A missing embedding model only costs retrieval, so failures are just logged
+            try {
+                indexRepository(repo_id, files);
+            } catch (const std::exception& e) {
+                std::cerr << "⚠️  Skipping embeddings for " << repo_id << ": " << e.what() << std::endl;
+            }
+        }
+    }
+
+public:
+    explicit EmbeddingService(std::shared_ptr<LLMService> llm)
+        : llm_service(std::move(llm)) {
+        const char* summaries = std::getenv("SUMMARIES_PATH");
+        summaries_path = summaries ? summaries : "./data/summaries";
+
+        const char* batch = std::getenv("EMBED_BATCH_SIZE");
+        batch_size = batch ? std::max(1, std::atoi(batch)) : 32;
+
+        const char* k = std::getenv("EMBED_TOP_K");
+        top_k = k ? std::max(1, std::atoi(k)) : 40;
+
+        const char* stored = std::getenv("EMBED_PRECISION");
+        precision = VectorIndex::parsePrecision(stored ? stored : "int8");
+
+        std::cout << "✓ Embedding retrieval: " << llm_service->getEmbeddingModel() << ", "
+                  << VectorIndex::precisionName(precision) << " vectors, top " << top_k
+                  << " files (" << vector_kernels::isa() << " similarity scan)" << std::endl;
+
+        worker = std::thread(&EmbeddingService::workerLoop, this);
+    }
+
+    ~EmbeddingService() {
+        stopping = true;
+        work_available.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    // Queue a scan's files for indexRepository on the background worker and return at once.
+    // Scans queued again before the worker reaches them are only indexed in their latest form.
+    void enqueueIndex(const std::string& repo_id, json files) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            pending[repo_id] = std::move(files);
+        }
+        work_available.notify_one();
+    }
+
+    // Embed a scan's files and write the repository's vector file. Files whose text is
+    // unchanged since the previous index keep their vectors. Returns the number embedded.
+    size_t indexRepository(const std::string& repo_id, const json& files) {
+        if (!llm_service->isAvailable()) {
+            throw std::runtime_error("LLM service unavailable");
+        }
+        std::string model = llm_service->getEmbeddingModel();
+
+        std::shared_ptr<const VectorIndex> previous;
+        try {
+            previous = loadIndex(repo_id);
+        } catch (const std::exception& e) {
+            std::cerr << "⚠️  Rebuilding unreadable vector index of " << repo_id << ": " << e.what() << std::endl;
+        }
+        if (previous && (previous->model() != model || previous->precision() != precision)) {
+            previous = nullptr;
+        }
+
+        // Texts that need a (new) embedding; the rest are reused from the previous index
+        std::vector<std::string> paths;
+        std::vector<std::string> hashes;
+        std::vector<std::string> texts;
+        std::vector<size_t> to_embed;
+        for (auto& [file_path, file_info] : files.items()) {
+            // Near-duplicates never reach a prompt on their own; their representative stands in
+            if (ContextBuilder::isNearDuplicate(file_info)) continue;
+            std::string text = embeddingText(file_path, file_info);
+            std::string hash = ContentHash::sha256(text);
+            long row = previous ? previous->find(file_path) : -1;
+            if (row < 0 || previous->textHash(row) != hash) to_embed.push_back(paths.size());
+            paths.push_back(file_path);
+            hashes.push_back(hash);
+            texts.push_back(std::move(text));
+        }
+
+        if (previous && to_embed.empty() && previous->size() == paths.size()) return 0;
+        if (paths.empty()) {
+            std::error_code ec;
+            fs::remove(indexFile(repo_id), ec);
+            return 0;
+        }
+
+        std::map<size_t, std::vector<float>> embedded;
+        for (size_t start = 0; start < to_embed.size(); start += batch_size) {
+            std::vector<std::string> batch;
+            for (size_t i = start; i < std::min(start + batch_size, to_embed.size()); ++i) {
+                batch.push_back(texts[to_embed[i]]);
+            }
+            auto vectors = llm_service->embed(batch);
+            for (size_t i = 0; i < vectors.size(); ++i) {
+                embedded[to_embed[start + i]] = std::move(vectors[i]);
+            }
+        }
+
+        size_t dimension = embedded.empty() ? previous->dimension() : embedded.begin()->second.size();
+        if (previous && previous->dimension() != dimension) {
+            throw std::runtime_error("Embedding dimension changed from " + std::to_string(previous->dimension()) +
+                                     " to " + std::to_string(dimension) + " for model " + model);
+        }
+
+        VectorIndex index(dimension, precision, model);
+        for (size_t i = 0; i < paths.size(); ++i) {
+            auto it = embedded.find(i);
+            if (it != embedded.end()) {
+                index.add(paths[i], hashes[i], it->second);
+            } else {
+                index.copyRow(*previous, previous->find(paths[i]));
+            }
+        }
+        index.save(indexFile(repo_id));
+
+        std::cout << "🧭 Embedded " << embedded.size() << " files of " << repo_id << " ("
+                  << paths.size() - embedded.size() << " unchanged, " << dimension << " dimensions)" << std::endl;
+        return embedded.size();
+    }
+
+    // Files most similar to the query, best first, with their cosine similarity. Empty when
+    // the repository has no vector file or the query can't be embedded.
+    std::vector<std::pair<std::string, float>> retrieve(const std::string& repo_id, const std::string& query,
+                                                        size_t k = 0) {
+        std::vector<std::pair<std::string, float>> results;
+        try {
+            auto index = loadIndex(repo_id);
+            if (!index || index->size() == 0) return results;
+
+            std::string query_key = index->model() + "\n" + query;
+            std::vector<float> query_vector;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto it = query_vectors.find(query_key);
+                if (it != query_vectors.end()) query_vector = it->second;
+            }
+            if (query_vector.empty()) {
+                if (index->model() != llm_service->getEmbeddingModel() || !llm_service->isAvailable()) return results;
+                query_vector = llm_service->embed({query}).front();
+                std::lock_guard<std::mutex> lock(mutex);
+                query_vectors[query_key] = query_vector;
+            }
+
+            for (const auto& match : index->search(query_vector, k > 0 ? k : top_k)) {
+                results.push_back({index->path(match.row), match.score});
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "⚠️  Embedding retrieval unavailable for " << repo_id << ": " << e.what() << std::endl;
+        }
+        return results;
+    }
+};
+
+#endif // EMBEDDING_SERVICE_H
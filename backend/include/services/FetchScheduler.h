@@ -0,0 +1,322 @@
+#ifndef FETCH_SCHEDULER_H
+#define FETCH_SCHEDULER_H
+
+#include <string>
+#include <map>
+#include <set>
+#include <list>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include "GitHubService.h"
+
+using json = nlohmann::json;
+
+// Runs clones and mirror fetches on a bounded worker pool with a per-host
+// concurrency cap, so a burst of repository additions queues up instead of
+// launching dozens of git processes at once. While the pool is idle, a
+// background refresher re-fetches every known mirror so user-triggered adds
+// usually find their objects already present.
+class FetchScheduler {
+public:
+    using CloneResult = std::map<std::string, std::string>;
+
+private:
+    struct FetchJob {
+        long long id;
+        std::string kind;          // "clone" (user request) or "refresh" (background)
+        std::string key;
+        std::string url;
+        std::string host;
+        std::string branch;
+        std::string checkout_mode;
+        std::string commit;
+        std::string mirror_path;
+        std::string state = "queued";
+        std::chrono::steady_clock::time_point enqueued_at;
+        std::chrono::steady_clock::time_point started_at;
+        std::promise<CloneResult> promise;
+        std::shared_future<CloneResult> result;
+    };
+
+    std::shared_ptr<GitHubService> github_service;
+    size_t worker_count;
+    size_t per_host_limit;
+    std::chrono::seconds refresh_interval;
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable refresh_wakeup;
+    std::list<std::shared_ptr<FetchJob>> queue;
+    std::map<long long, std::shared_ptr<FetchJob>> running;
+    std::map<std::string, size_t> active_per_host;
+    long long next_job_id = 1;
+    long long completed_jobs = 0;
+    long long failed_jobs = 0;
+    long long refreshes_completed = 0;
+    std::atomic<bool> stopping{false};
+    std::vector<std::thread> workers;
+    std::thread refresher;
+
+    static long long millisSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Host part of a remote URL ("https://host/x", "git@host:x"); local remotes share one slot pool
+    static std::string extractHost(const std::string& url) {
+        size_t scheme = url.find("://");
+        if (scheme != std::string::npos) {
+            if (url.compare(0, scheme, "file") == 0) return "local";
+            size_t start = scheme + 3;
+            size_t at = url.find('@', start);
+            size_t slash = url.find('/', start);
+            if (at != std::string::npos && at < slash) start = at + 1;
+            return url.substr(start, slash == std::string::npos ? std::string::npos : slash - start);
+        }
+
+        size_t at = url.find('@');
+        size_t colon = url.find(':');
+        if (colon != std::string::npos) {
+            size_t start = (at != std::string::npos && at < colon) ? at + 1 : 0;
+            return url.substr(start, colon - start);
+        }
+        return "local";
+    }
+
+    // Pick the first runnable job whose host is under its limit; user clones go before refreshes
+    std::shared_ptr<FetchJob> takeRunnableJob() {
+        for (const char* kind : {"clone", "refresh"}) {
+            for (auto it = queue.begin(); it != queue.end(); ++it) {
+                if ((*it)->kind != kind) continue;
+                if (active_per_host[(*it)->host] >= per_host_limit) continue;
+
+                auto job = *it;
+                queue.erase(it);
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void workerLoop() {
+        while (true) {
+            std::shared_ptr<FetchJob> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                work_available.wait(lock, [this, &job] {
+                    if (stopping) return true;
+                    job = takeRunnableJob();
+                    return job != nullptr;
+                });
+                if (!job) return;
+
+                job->state = "running";
+                job->started_at = std::chrono::steady_clock::now();
+                active_per_host[job->host]++;
+                running[job->id] = job;
+            }
+
+            bool succeeded = true;
+            try {
+                if (job->kind == "refresh") {
+                    github_service->refreshMirror(job->mirror_path, job->url);
+                    job->promise.set_value({});
+                } else {
+                    job->promise.set_value(github_service->cloneRepository(
+                        job->url, job->branch, job->checkout_mode, job->commit));
+                }
+            } catch (const std::exception& e) {
+                succeeded = false;
+                std::cerr << "❌ Fetch job " << job->id << " (" << job->kind << " " << job->url
+                          << ") failed: " << e.what() << std::endl;
+                job->promise.set_exception(std::current_exception());
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                active_per_host[job->host]--;
+                running.erase(job->id);
+                if (succeeded) completed_jobs++; else failed_jobs++;
+                if (succeeded && job->kind == "refresh") refreshes_completed++;
+            }
+            // A slot on this host opened up; jobs blocked on the host limit may run now
+            work_available.notify_all();
+        }
+    }
+
+    // Periodically queue a refresh for each known mirror while no user work is pending
+    void refreshLoop() {
+        while (!stopping) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                refresh_wakeup.wait_for(lock, refresh_interval, [this] { return stopping.load(); });
+                if (stopping) return;
+
+                // Only refresh in idle time
+                if (!queue.empty() || !running.empty()) continue;
+            }
+
+            for (const auto& mirror : github_service->listMirrors()) {
+                std::lock_guard<std::mutex> lock(mutex);
+                std::string key = "refresh:" + mirror.at("mirror_path");
+                if (findQueued(key)) continue;
+
+                auto job = std::make_shared<FetchJob>();
+                job->id = next_job_id++;
+                job->kind = "refresh";
+                job->key = key;
+                job->url = mirror.at("url");
+                job->host = extractHost(job->url);
+                job->mirror_path = mirror.at("mirror_path");
+                job->enqueued_at = std::chrono::steady_clock::now();
+                job->result = job->promise.get_future().share();
+                queue.push_back(job);
+            }
+            work_available.notify_all();
+        }
+    }
+
+    // Find a queued (not yet running) job with the same key (caller holds the mutex)
+    std::shared_ptr<FetchJob> findQueued(const std::string& key) {
+        for (const auto& job : queue) {
+            if (job->key == key) return job;
+        }
+        return nullptr;
+    }
+
+    static json describeJob(const FetchJob& job, size_t position) {
+        json entry;
+        entry["id"] = job.id;
+        entry["kind"] = job.kind;
+        entry["url"] = job.url;
+        entry["host"] = job.host;
+        entry["state"] = job.state;
+        if (job.kind == "clone") {
+            entry["branch"] = job.branch;
+            entry["checkout_mode"] = job.checkout_mode;
+            if (!job.commit.empty()) entry["commit"] = job.commit;
+        }
+        if (job.state == "queued") {
+            entry["position"] = position;
+            entry["waiting_ms"] = millisSince(job.enqueued_at);
+        } else {
+            entry["waited_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                job.started_at - job.enqueued_at).count();
+            entry["running_ms"] = millisSince(job.started_at);
+        }
+        return entry;
+    }
+
+public:
+    explicit FetchScheduler(std::shared_ptr<GitHubService> service)
+        : github_service(std::move(service)) {
+        const char* workers_env = std::getenv("FETCH_WORKERS");
+        worker_count = workers_env ? std::max(1, std::atoi(workers_env)) : 4;
+
+        const char* host_limit_env = std::getenv("FETCH_PER_HOST_LIMIT");
+        per_host_limit = host_limit_env ? std::max(1, std::atoi(host_limit_env)) : 2;
+
+        const char* refresh_env = std::getenv("MIRROR_REFRESH_INTERVAL_SEC");
+        refresh_interval = std::chrono::seconds(refresh_env ? std::atoi(refresh_env) : 900);
+
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers.emplace_back(&FetchScheduler::workerLoop, this);
+        }
+        if (refresh_interval.count() > 0) {
+            refresher = std::thread(&FetchScheduler::refreshLoop, this);
+        }
+
+        std::cout << "✓ Fetch scheduler started (" << worker_count << " workers, "
+                  << per_host_limit << " per host, refresh every "
+                  << refresh_interval.count() << "s)" << std::endl;
+    }
+
+    ~FetchScheduler() {
+        stopping = true;
+        work_available.notify_all();
+        refresh_wakeup.notify_all();
+        for (auto& worker : workers) worker.join();
+        if (refresher.joinable()) refresher.join();
+    }
+
+    FetchScheduler(const FetchScheduler&) = delete;
+    FetchScheduler& operator=(const FetchScheduler&) = delete;
+
+    // Queue a clone; identical requests still waiting in the queue share one job
+    std::shared_future<CloneResult> submitClone(
+        const std::string& url,
+        const std::string& branch,
+        const std::string& checkout_mode = "",
+        const std::string& commit = ""
+    ) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::string key = "clone:" + url + "#" + branch + "#" + checkout_mode + "#" + commit;
+        if (auto existing = findQueued(key)) {
+            return existing->result;
+        }
+
+        auto job = std::make_shared<FetchJob>();
+        job->id = next_job_id++;
+        job->kind = "clone";
+        job->key = key;
+        job->url = url;
+        job->host = extractHost(url);
+        job->branch = branch;
+        job->checkout_mode = checkout_mode;
+        job->commit = commit;
+        job->enqueued_at = std::chrono::steady_clock::now();
+        job->result = job->promise.get_future().share();
+        queue.push_back(job);
+
+        if (queue.size() > 1 || running.size() >= worker_count) {
+            std::cout << "⏳ Queued clone of " << url << " (" << queue.size() << " waiting)" << std::endl;
+        }
+
+        work_available.notify_all();
+        return job->result;
+    }
+
+    // Snapshot of running and queued jobs plus scheduler counters
+    json getStatus() {
+        std::lock_guard<std::mutex> lock(mutex);
+        json status;
+
+        json running_jobs = json::array();
+        for (const auto& [_, job] : running) {
+            running_jobs.push_back(describeJob(*job, 0));
+        }
+
+        json queued_jobs = json::array();
+        size_t position = 0;
+        for (const auto& job : queue) {
+            queued_jobs.push_back(describeJob(*job, ++position));
+        }
+
+        json hosts = json::object();
+        for (const auto& [host, active] : active_per_host) {
+            if (active > 0) hosts[host] = active;
+        }
+
+        status["workers"] = worker_count;
+        status["per_host_limit"] = per_host_limit;
+        status["refresh_interval_sec"] = refresh_interval.count();
+        status["running"] = running_jobs;
+        status["queued"] = queued_jobs;
+        status["active_per_host"] = hosts;
+        status["completed_jobs"] = completed_jobs;
+        status["failed_jobs"] = failed_jobs;
+        status["refreshes_completed"] = refreshes_completed;
+        return status;
+    }
+};
+
+#endif // FETCH_SCHEDULER_H
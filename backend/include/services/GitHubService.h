@@ -11,13 +11,213 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <shared_mutex>
+#include <algorithm>
+#include "../utils/SingleFlight.h"
+#include "../utils/RepositoryLocks.h"
+#include "../utils/LanguageRegistry.h"
+#include "RepositoryStore.h"
 
 namespace fs = std::filesystem;
 
 class GitHubService {
 private:
     std::string base_path;
+    std::string mirrors_path;
     std::string github_token;
+    int mirror_fetch_depth;
+    std::string default_checkout_mode;
+    std::string sparse_blob_limit;
+
+    // Canonical directories local repositories may be registered from; empty disables them
+    std::vector<fs::path> local_repo_roots;
+
+    // Concurrent clones of the same checkout attach to the one already running
+    SingleFlight<std::string, std::map<std::string, std::string>> clone_flight;
+
+    // Size/last-access tracking and quota enforcement for checkouts (optional)
+    std::shared_ptr<RepositoryStore> repository_store;
+
+    // One lock per mirror so concurrent branch checkouts don't race on the same object store
+    std::mutex mirror_locks_mutex;
+    std::map<std::string, std::unique_ptr<std::mutex>> mirror_locks;
+
+    std::mutex& mirrorLock(const std::string& mirror_path) {
+        std::lock_guard<std::mutex> lock(mirror_locks_mutex);
+        auto& entry = mirror_locks[mirror_path];
+        if (!entry) entry = std::make_unique<std::mutex>();
+        return *entry;
+    }
+
+    // Quote a value for use as a single shell argument
+    static std::string shellQuote(const std::string& value) {
+        std::string quoted = "'";
+        for (char c : value) {
+            if (c == '\'') quoted += "'\\''";
+            else quoted += c;
+        }
+        return quoted + "'";
+    }
+
+    // Run a command and capture its trimmed stdout; throws if it exits non-zero
+    static std::string runCommandOutput(const std::string& cmd) {
+        FILE* pipe = popen(cmd.c_str(), "r");
+        if (!pipe) {
+            throw std::runtime_error("Failed to run command: " + cmd);
+        }
+
+        std::string output;
+        char buffer[256];
+        while (fgets(buffer, sizeof(buffer), pipe)) {
+            output += buffer;
+        }
+
+        if (pclose(pipe) != 0) {
+            throw std::runtime_error("Command failed: " + cmd);
+        }
+
+        output.erase(output.find_last_not_of(" \t\r\n") + 1);
+        return output;
+    }
+
+    static long long elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Checkouts of the default branch keep the URL-only id so existing summaries stay addressable
+    std::string generateCheckoutId(const std::string& url, const std::string& branch) {
+        return branch == "main" ? generateRepoId(url) : generateRepoId(url + "#" + branch);
+    }
+
+    // Make sure the bare mirror for a remote exists and has the latest objects for one branch.
+    // Only objects missing from the mirror are transferred.
+    // With partial=true the mirror becomes a partial clone: blobs above sparse_blob_limit are
+    // left on the remote and fetched lazily only if a checkout actually needs them. The
+    // promisor settings persist in the mirror, so only the separate partial mirror from
+    // getMirrorPath(url, true) may be fetched this way.
+    void fetchIntoMirror(const std::string& mirror_path, const std::string& url, const std::string& branch,
+                         bool partial = false) {
+        if (!fs::exists(mirror_path)) {
+            std::cout << "🪞 Creating mirror: " << mirror_path << std::endl;
+            std::string init_cmd = "git init --quiet --bare " + shellQuote(mirror_path) +
+                                   " && git --git-dir=" + shellQuote(mirror_path) +
+                                   " remote add origin " + shellQuote(url) + " 2>&1";
+            if (system(init_cmd.c_str()) != 0) {
+                fs::remove_all(mirror_path);
+                throw std::runtime_error("Failed to initialize mirror for " + url);
+            }
+        }
+
+        std::string filter;
+        if (partial) {
+            std::string filter_spec = "blob:limit=" + sparse_blob_limit;
+            std::string promisor_cmd = "git --git-dir=" + shellQuote(mirror_path) + " config remote.origin.promisor true" +
+                                       " && git --git-dir=" + shellQuote(mirror_path) +
+                                       " config remote.origin.partialclonefilter " + shellQuote(filter_spec) + " 2>&1";
+            if (system(promisor_cmd.c_str()) != 0) {
+                throw std::runtime_error("Failed to configure partial clone for " + url);
+            }
+            filter = " --filter=" + shellQuote(filter_spec);
+        }
+
+        std::string depth = mirror_fetch_depth > 0 ? " --depth " + std::to_string(mirror_fetch_depth) : "";
+        std::string fetch_cmd = "git --git-dir=" + shellQuote(mirror_path) + " fetch --quiet --prune" + depth + filter +
+                                " origin " + shellQuote("+refs/heads/" + branch + ":refs/heads/" + branch) + " 2>&1";
+
+        if (system(fetch_cmd.c_str()) != 0) {
+            throw std::runtime_error("Failed to clone repository. Check URL and branch name.");
+        }
+    }
+
+    // Make sure a specific (possibly historical) commit is present in the mirror
+    void fetchCommitIntoMirror(const std::string& mirror_path, const std::string& commit) {
+        std::string exists_cmd = "git --git-dir=" + shellQuote(mirror_path) + " cat-file -e " +
+                                 shellQuote(commit + "^{commit}") + " 2>/dev/null";
+        if (system(exists_cmd.c_str()) == 0) return;
+
+        std::string depth = mirror_fetch_depth > 0 ? " --depth " + std::to_string(mirror_fetch_depth) : "";
+        std::string fetch_cmd = "git --git-dir=" + shellQuote(mirror_path) + " fetch --quiet" + depth +
+                                " origin " + shellQuote(commit) + " 2>&1";
+        if (system(fetch_cmd.c_str()) != 0) {
+            throw std::runtime_error("Failed to fetch commit " + commit + " from remote");
+        }
+    }
+
+    // Materialize (or move) a detached worktree at the mirror's branch tip. With sparse=true only
+    // the files the scanner analyzes are written to disk.
+    void checkoutWorktree(const std::string& mirror_path, const std::string& local_path, const std::string& branch,
+                          bool sparse = false) {
+        std::string ref = shellQuote("refs/heads/" + branch);
+        std::string git = "git -C " + shellQuote(local_path);
+
+        if (fs::exists(fs::path(local_path) / ".git") && !isWorktreeOf(local_path, mirror_path)) {
+            // Switching between sparse and full moves the checkout to the other mirror
+            std::cout << "🔀 Moving worktree to mirror " << mirror_path << std::endl;
+            fs::remove_all(local_path);
+        }
+
+        if (!fs::exists(fs::path(local_path) / ".git")) {
+            // Forget worktrees whose directories were removed out from under the mirror
+            std::string prune_cmd = "git --git-dir=" + shellQuote(mirror_path) + " worktree prune 2>&1";
+            if (system(prune_cmd.c_str()) != 0) {
+                std::cout << "⚠ Warning: Failed to prune stale worktrees" << std::endl;
+            }
+
+            std::string add_cmd = "git --git-dir=" + shellQuote(mirror_path) + " worktree add --quiet --force --no-checkout --detach " +
+                                  shellQuote(local_path) + " " + ref + " 2>&1";
+            if (system(add_cmd.c_str()) != 0) {
+                throw std::runtime_error("Failed to create worktree at " + local_path);
+            }
+        }
+
+        if (sparse) {
+            std::string patterns;
+            for (const auto& pattern : LanguageRegistry::getSparseCheckoutPatterns()) {
+                patterns += " " + shellQuote(pattern);
+            }
+            std::string sparse_cmd = git + " sparse-checkout set --no-cone" + patterns + " 2>&1";
+            if (system(sparse_cmd.c_str()) != 0) {
+                throw std::runtime_error("Failed to configure sparse checkout at " + local_path);
+            }
+        } else if (isSparseCheckout(local_path)) {
+            std::string disable_cmd = git + " sparse-checkout disable 2>&1";
+            if (system(disable_cmd.c_str()) != 0) {
+                throw std::runtime_error("Failed to disable sparse checkout at " + local_path);
+            }
+        }
+
+        std::string checkout_cmd = git + " checkout --quiet --force --detach " + ref + " 2>&1";
+        if (system(checkout_cmd.c_str()) != 0) {
+            throw std::runtime_error("Failed to check out worktree at " + local_path);
+        }
+    }
+
+    // Whether a worktree's object database is the given mirror
+    static bool isWorktreeOf(const std::string& local_path, const std::string& mirror_path) {
+        try {
+            std::string common_dir = runCommandOutput("git -C " + shellQuote(local_path) +
+                                                      " rev-parse --path-format=absolute --git-common-dir 2>/dev/null");
+            std::error_code ec;
+            return fs::equivalent(common_dir, mirror_path, ec);
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    static bool isSparseCheckout(const std::string& local_path) {
+        try {
+            return runCommandOutput("git -C " + shellQuote(local_path) +
+                                    " config --bool core.sparseCheckout 2>/dev/null") == "true";
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
 
     // Generate unique repository ID from URL using MD5
     std::string generateRepoId(const std::string& url) {
@@ -81,53 +281,332 @@ public:
         const char* repos_path = std::getenv("REPOS_PATH");
         base_path = repos_path ? repos_path : "./data/repositories";
         
-        // Create base directory if it doesn't exist
+        // Bare mirrors shared by every branch checkout of a remote
+        const char* mirrors = std::getenv("MIRROR_CACHE_PATH");
+        mirrors_path = mirrors ? mirrors : "./data/mirrors";
+
+        // History depth fetched into mirrors (0 = full history)
+        const char* depth = std::getenv("MIRROR_FETCH_DEPTH");
+        mirror_fetch_depth = depth ? std::atoi(depth) : 1;
+
+        // Checkout mode when the caller doesn't pick one: "full" or "sparse"
+        const char* checkout_mode = std::getenv("CHECKOUT_MODE");
+        default_checkout_mode = checkout_mode ? checkout_mode : "full";
+
+        // Largest blob a sparse checkout's partial fetch downloads eagerly
+        const char* blob_limit = std::getenv("SPARSE_BLOB_LIMIT");
+        sparse_blob_limit = blob_limit ? blob_limit : "256k";
+
+        // Comma-separated directories that /api/repos/add-local may ingest from
+        const char* local_roots = std::getenv("LOCAL_REPO_ROOTS");
+        if (local_roots) {
+            std::stringstream roots(local_roots);
+            std::string root;
+            while (std::getline(roots, root, ',')) {
+                root.erase(0, root.find_first_not_of(" \t"));
+                root.erase(root.find_last_not_of(" \t") + 1);
+                if (root.empty()) continue;
+
+                std::error_code ec;
+                fs::path canonical_root = fs::canonical(root, ec);
+                if (ec || !fs::is_directory(canonical_root)) {
+                    std::cerr << "⚠️  Ignoring local repository root that is not a directory: " << root << std::endl;
+                    continue;
+                }
+                local_repo_roots.push_back(canonical_root);
+            }
+        }
+        
+        // Create base directories if they don't exist
         fs::create_directories(base_path);
+        fs::create_directories(mirrors_path);
         std::cout << "✓ Repository storage path: " << base_path << std::endl;
+        std::cout << "✓ Mirror cache path: " << mirrors_path << std::endl;
+        if (local_repo_roots.empty()) {
+            std::cout << "⚠ Local repositories disabled (set LOCAL_REPO_ROOTS to enable)" << std::endl;
+        } else {
+            for (const auto& root : local_repo_roots) {
+                std::cout << "✓ Local repository root: " << root.string() << std::endl;
+            }
+        }
     }
 
-    // Clone a GitHub repository
+    // Whether any LOCAL_REPO_ROOTS are configured
+    bool localRepositoriesEnabled() const {
+        return !local_repo_roots.empty();
+    }
+
+    // Absolute path of the bare mirror that backs a remote URL. Sparse checkouts get their own
+    // partial-clone mirror so full checkouts and bare scans never depend on lazily fetched blobs.
+    std::string getMirrorPath(const std::string& github_url, bool partial = false) {
+        std::string name = generateRepoId(github_url) + (partial ? "-partial.git" : ".git");
+        return fs::absolute(fs::path(mirrors_path) / name).string();
+    }
+
+    // Check whether a checkout mode name is supported
+    static bool isValidCheckoutMode(const std::string& mode) {
+        return mode == "full" || mode == "sparse" || mode == "bare";
+    }
+
+    // Clone a GitHub repository: fetch the branch into the remote's bare mirror and
+    // materialize it as a worktree under base_path/<repo_id>. Concurrent calls for the
+    // same checkout and mode share one clone and its result; a call with another mode
+    // waits on the repository lock and then redoes the checkout in its own mode.
+    //
+    // checkout_mode "sparse" fetches with a blob size filter and only materializes files
+    // the scanner analyzes; "full" checks out everything; "bare" only fetches into the
+    // mirror (no working tree) for scanning straight from the object database. Empty
+    // means CHECKOUT_MODE. A bare fetch may pin a historical commit instead of the tip.
     std::map<std::string, std::string> cloneRepository(
         const std::string& github_url, 
-        const std::string& branch = "main"
+        const std::string& branch = "main",
+        const std::string& checkout_mode = "",
+        const std::string& commit = ""
+    ) {
+        std::string mode = checkout_mode.empty() ? default_checkout_mode : checkout_mode;
+        if (!isValidCheckoutMode(mode)) {
+            throw std::runtime_error("Unknown checkout mode: " + mode);
+        }
+        if (!commit.empty() && mode != "bare") {
+            throw std::runtime_error("Scanning a specific commit requires the bare checkout mode");
+        }
+        
+        std::string repo_id = commit.empty()
+            ? generateCheckoutId(github_url, branch)
+            : generateRepoId(github_url + "@" + commit);
+        
+        bool joined = false;
+        auto metadata = clone_flight.run(repo_id + "#" + mode, [&]() {
+            std::unique_lock<std::shared_mutex> lock(RepositoryLocks::forRepo(repo_id));
+            return performClone(github_url, branch, repo_id, mode, commit);
+        }, &joined);
+        
+        if (joined) {
+            std::cout << "🔗 Joined in-flight clone of " << repo_id << std::endl;
+        } else if (repository_store) {
+            repository_store->recordCheckout(metadata);
+        }
+        
+        return metadata;
+    }
+
+    // Attach the store that tracks checkout sizes and enforces the disk quota
+    void setRepositoryStore(std::shared_ptr<RepositoryStore> store) {
+        repository_store = std::move(store);
+    }
+
+    // List every bare mirror in the cache with the remote URL it tracks
+    std::vector<std::map<std::string, std::string>> listMirrors() {
+        std::vector<std::map<std::string, std::string>> mirrors;
+        std::error_code ec;
+        
+        for (const auto& entry : fs::directory_iterator(mirrors_path, ec)) {
+            if (!entry.is_directory() || entry.path().extension() != ".git") continue;
+            
+            std::string mirror_path = fs::absolute(entry.path()).string();
+            try {
+                std::map<std::string, std::string> mirror;
+                mirror["mirror_path"] = mirror_path;
+                mirror["url"] = runCommandOutput("git --git-dir=" + shellQuote(mirror_path) +
+                                                 " config --get remote.origin.url");
+                mirrors.push_back(mirror);
+            } catch (const std::exception& e) {
+                std::cerr << "⚠ Skipping unreadable mirror " << mirror_path << ": " << e.what() << std::endl;
+            }
+        }
+        
+        return mirrors;
+    }
+
+    // Fetch the latest objects for every branch a mirror already tracks
+    void refreshMirror(const std::string& mirror_path, const std::string& url) {
+        std::lock_guard<std::mutex> lock(mirrorLock(mirror_path));
+        
+        std::string branches = runCommandOutput("git --git-dir=" + shellQuote(mirror_path) +
+                                                " for-each-ref --format='%(refname:lstrip=2)' refs/heads");
+        std::istringstream stream(branches);
+        std::string branch;
+        while (std::getline(stream, branch)) {
+            if (!branch.empty()) {
+                fetchIntoMirror(mirror_path, url, branch);
+            }
+        }
+    }
+
+    // Repository id for an uploaded archive, stable across re-uploads under the same name
+    std::string generateUploadId(const std::string& name) {
+        return generateRepoId("upload://" + name);
+    }
+
+    // Register a locally mounted repository without cloning it
+    std::map<std::string, std::string> registerLocalRepository(const std::string& path) {
+        std::error_code ec;
+        fs::path local_path = fs::canonical(path, ec);
+
+        if (ec || !fs::is_directory(local_path)) {
+            throw std::runtime_error("Local repository path does not exist or is not a directory: " + path);
+        }
+
+        // Compared after canonicalization, so ".." and symlinks can't escape a root
+        bool allowed = false;
+        for (const auto& root : local_repo_roots) {
+            auto mismatch = std::mismatch(root.begin(), root.end(), local_path.begin(), local_path.end());
+            if (mismatch.first == root.end()) {
+                allowed = true;
+                break;
+            }
+        }
+        if (!allowed) {
+            throw std::runtime_error("Local repository path is outside LOCAL_REPO_ROOTS: " + path);
+        }
+
+        std::map<std::string, std::string> metadata;
+        metadata["repo_id"] = generateRepoId("local://" + local_path.string());
+        metadata["local_path"] = local_path.string();
+        metadata["source"] = "local";
+        metadata["repo_name"] = local_path.filename().string();
+
+        std::cout << "📁 Registered local repository: " << local_path.string() << std::endl;
+        return metadata;
+    }
+
+    // Read .gitignore patterns; static, so scans and watch flushes don't construct the service
+    static std::vector<std::string> getGitignorePatterns(const std::string& local_path) {
+        std::string gitignore_path = local_path + "/.gitignore";
+        std::string content;
+        
+        if (fs::exists(gitignore_path)) {
+            std::ifstream file(gitignore_path);
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            content = buffer.str();
+            file.close();
+        }
+        
+        return parseGitignorePatterns(content);
+    }
+
+    // Parse .gitignore content (empty if there is none) and append the default patterns
+    static std::vector<std::string> parseGitignorePatterns(const std::string& content) {
+        std::vector<std::string> patterns;
+        std::istringstream stream(content);
+        std::string line;
+        
+        while (std::getline(stream, line)) {
+            // Trim whitespace
+            line.erase(0, line.find_first_not_of(" \t\r\n"));
+            line.erase(line.find_last_not_of(" \t\r\n") + 1);
+            
+            // Skip empty lines and comments
+            if (!line.empty() && line[0] != '#') {
+                patterns.push_back(line);
+            }
+        }
+        
+        if (!patterns.empty()) {
+            std::cout << "✓ Loaded " << patterns.size() << " patterns from .gitignore" << std::endl;
+        }
+        
+        // Add default patterns to ignore
+        patterns.push_back(".git");
+        patterns.push_back("__pycache__");
+        patterns.push_back("node_modules");
+        patterns.push_back("venv");
+        patterns.push_back(".env");
+        patterns.push_back("build");
+        patterns.push_back("dist");
+        patterns.push_back(".next");
+        
+        return patterns;
+    }
+
+private:
+    // Fetch and check out one (url, branch); callers hold the repository's exclusive lock
+    std::map<std::string, std::string> performClone(
+        const std::string& github_url,
+        const std::string& branch,
+        const std::string& repo_id,
+        const std::string& checkout_mode,
+        const std::string& commit
     ) {
         std::map<std::string, std::string> metadata;
         
-        std::string repo_id = generateRepoId(github_url);
         std::string local_path = base_path + "/" + repo_id;
+        bool sparse = checkout_mode == "sparse";
+        std::string mirror_path = getMirrorPath(github_url, sparse);
         
         metadata["repo_id"] = repo_id;
         metadata["github_url"] = github_url;
         metadata["local_path"] = local_path;
         metadata["branch"] = branch;
+        metadata["mirror_path"] = mirror_path;
+        metadata["checkout_mode"] = checkout_mode;
         
-        // Check if already cloned
-        if (fs::exists(local_path)) {
+        if (checkout_mode == "bare") {
+            // No working tree: the scanner reads blobs from the mirror directly
+            metadata["local_path"] = "";
+            
+            std::cout << "📥 Fetching repository into mirror (no checkout)..." << std::endl;
+            std::cout << "   URL: " << github_url << std::endl;
+            std::cout << "   Branch: " << branch << std::endl;
+            std::cout << "   Mirror: " << mirror_path << std::endl;
+            
+            std::lock_guard<std::mutex> lock(mirrorLock(mirror_path));
+            bool mirror_hit = fs::exists(mirror_path);
+            
+            auto fetch_start = std::chrono::steady_clock::now();
+            fetchIntoMirror(mirror_path, github_url, branch);
+            if (!commit.empty()) {
+                fetchCommitIntoMirror(mirror_path, commit);
+            }
+            long long fetch_ms = elapsedMs(fetch_start);
+            
+            std::string rev = commit.empty() ? "refs/heads/" + branch : commit;
+            metadata["mirror_hit"] = mirror_hit ? "true" : "false";
+            metadata["fetch_ms"] = std::to_string(fetch_ms);
+            metadata["checkout_ms"] = "0";
+            metadata["commit"] = runCommandOutput("git --git-dir=" + shellQuote(mirror_path) +
+                                                  " rev-parse --verify " + shellQuote(rev + "^{commit}"));
+            
+            std::cout << "✅ Mirror ready at " << metadata["commit"].substr(0, 12)
+                      << " (mirror " << (mirror_hit ? "hit" : "miss") << ", fetch " << fetch_ms << " ms)" << std::endl;
+        } else if (fs::is_directory(fs::path(local_path) / ".git")) {
+            // Checkouts made before the mirror cache existed are plain clones; keep pulling those
             std::cout << "📁 Repository already exists at: " << local_path << std::endl;
             std::cout << "🔄 Pulling latest changes..." << std::endl;
             
-            std::string pull_cmd = "cd " + local_path + " && git pull origin " + branch + " 2>&1";
+            std::string pull_cmd = "cd " + shellQuote(local_path) + " && git pull origin " + shellQuote(branch) + " 2>&1";
             int result = system(pull_cmd.c_str());
             
             if (result != 0) {
                 std::cout << "⚠ Warning: Failed to pull latest changes" << std::endl;
             }
         } else {
-            std::cout << "📥 Cloning repository..." << std::endl;
+            std::cout << "📥 Fetching repository into mirror..." << std::endl;
             std::cout << "   URL: " << github_url << std::endl;
             std::cout << "   Branch: " << branch << std::endl;
-            std::cout << "   Destination: " << local_path << std::endl;
+            std::cout << "   Mirror: " << mirror_path << std::endl;
+            std::cout << "   Worktree: " << local_path << " (" << checkout_mode << " checkout)" << std::endl;
             
-            std::string clone_cmd = "git clone --depth 1 --branch " + branch + 
-                                   " " + github_url + " " + local_path + " 2>&1";
+            std::lock_guard<std::mutex> lock(mirrorLock(mirror_path));
+            bool mirror_hit = fs::exists(mirror_path);
             
-            int result = system(clone_cmd.c_str());
+            auto fetch_start = std::chrono::steady_clock::now();
+            fetchIntoMirror(mirror_path, github_url, branch, sparse);
+            long long fetch_ms = elapsedMs(fetch_start);
             
-            if (result != 0) {
-                throw std::runtime_error("Failed to clone repository. Check URL and branch name.");
-            }
+            auto checkout_start = std::chrono::steady_clock::now();
+            checkoutWorktree(mirror_path, local_path, branch, sparse);
+            long long checkout_ms = elapsedMs(checkout_start);
             
-            std::cout << "✅ Repository cloned successfully!" << std::endl;
+            metadata["mirror_hit"] = mirror_hit ? "true" : "false";
+            metadata["fetch_ms"] = std::to_string(fetch_ms);
+            metadata["checkout_ms"] = std::to_string(checkout_ms);
+            metadata["commit"] = runCommandOutput("git -C " + shellQuote(local_path) + " rev-parse HEAD");
+            
+            std::cout << "✅ Repository ready at " << metadata["commit"].substr(0, 12)
+                      << " (mirror " << (mirror_hit ? "hit" : "miss") << ", fetch " << fetch_ms
+                      << " ms, checkout " << checkout_ms << " ms)" << std::endl;
         }
         
         // Parse URL for metadata
@@ -137,43 +616,6 @@ public:
         
         return metadata;
     }
-
-    // Read .gitignore patterns
-    std::vector<std::string> getGitignorePatterns(const std::string& local_path) {
-        std::vector<std::string> patterns;
-        std::string gitignore_path = local_path + "/.gitignore";
-        
-        if (fs::exists(gitignore_path)) {
-            std::ifstream file(gitignore_path);
-            std::string line;
-            
-            while (std::getline(file, line)) {
-                // Trim whitespace
-                line.erase(0, line.find_first_not_of(" \t\r\n"));
-                line.erase(line.find_last_not_of(" \t\r\n") + 1);
-                
-                // Skip empty lines and comments
-                if (!line.empty() && line[0] != '#') {
-                    patterns.push_back(line);
-                }
-            }
-            file.close();
-            
-            std::cout << "✓ Loaded " << patterns.size() << " patterns from .gitignore" << std::endl;
-        }
-        
-        // Add default patterns to ignore
-        patterns.push_back(".git");
-        patterns.push_back("__pycache__");
-        patterns.push_back("node_modules");
-        patterns.push_back("venv");
-        patterns.push_back(".env");
-        patterns.push_back("build");
-        patterns.push_back("dist");
-        patterns.push_back(".next");
-        
-        return patterns;
-    }
 };
 
 #endif // GITHUB_SERVICE_H
\ No newline at end of file
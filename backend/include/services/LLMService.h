@@ -7,18 +7,61 @@
 #include <nlohmann/json.hpp>
 #include <curl/curl.h>
 #include <memory>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <set>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include "OllamaRouter.h"
+#include "../utils/SingleFlight.h"
+#include "../utils/ContentHash.h"
 #include "../utils/SystemDetector.h"
 #include "../utils/ModelSelector.h"
 
 using json = nlohmann::json;
 
+// Thrown by LLMService::generateStream when the caller cancels mid-generation
+class GenerationCancelled : public std::runtime_error {
+public:
+    GenerationCancelled() : std::runtime_error("Generation cancelled") {}
+};
+
 class LLMService {
+public:
+    // Receives each generated fragment; returning false stops the generation
+    using TokenCallback = std::function<bool(const std::string& token)>;
+
 private:
-    std::string ollama_host;
     std::string model_name;
+    std::string embedding_model;
     SystemSpecs system_specs;
     ModelConfig model_config;
 
+    // Ollama servers with their health, load and speed; picks the backend for each request
+    std::unique_ptr<OllamaRouter> router;
+
+    // One upstream streaming generation that identical concurrent calls attach to. Tokens
+    // accumulate in output so a caller that attaches late first receives what it missed.
+    struct SharedStream {
+        std::mutex mutex;
+        std::condition_variable updated;
+        std::string output;
+        bool finished = false;
+        std::exception_ptr error;
+        size_t listeners = 1;               // attached callers that still want tokens
+        std::atomic<bool> abandoned{false}; // every caller detached; the upstream stops
+    };
+
+    // Identical in-flight requests share one upstream call
+    SingleFlight<std::string, json> request_flight;
+    std::mutex streams_mutex;
+    std::map<std::string, std::shared_ptr<SharedStream>> streams;
+    std::atomic<size_t> coalesced_requests{0};
+
     // Callback for CURL to write response data
     static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
         size_t total_size = size * nmemb;
@@ -26,15 +69,95 @@ private:
         return total_size;
     }
 
-    // Make HTTP POST request to Ollama API
-    std::string makeRequest(const std::string& endpoint, const json& payload) {
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            throw std::runtime_error("Failed to initialize CURL");
+    // State shared with the CURL callbacks of one streaming request
+    struct StreamState {
+        const TokenCallback* on_token = nullptr;
+        const std::function<bool()>* should_stop = nullptr;
+        std::string pending;        // bytes after the last complete NDJSON line
+        std::string output;
+        std::string error;
+        json final_chunk;           // carries eval_count / eval_duration
+        bool stopped = false;
+        bool done = false;
+    };
+
+    // Parse the complete NDJSON lines received so far and forward their tokens
+    static size_t StreamCallback(void* contents, size_t size, size_t nmemb, StreamState* state) {
+        size_t total_size = size * nmemb;
+        state->pending.append(static_cast<char*>(contents), total_size);
+
+        size_t start = 0;
+        for (size_t newline; (newline = state->pending.find('\n', start)) != std::string::npos; start = newline + 1) {
+            if (newline == start) continue;
+            json chunk = json::parse(state->pending.begin() + start, state->pending.begin() + newline, nullptr, false);
+            if (chunk.is_discarded()) continue;
+
+            if (chunk.contains("error")) {
+                state->error = chunk["error"].is_string() ? chunk["error"].get<std::string>() : chunk["error"].dump();
+                return 0;
+            }
+
+            std::string token = chunk.value("response", "");
+            if (!token.empty()) {
+                state->output += token;
+                if (!(*state->on_token)(token)) {
+                    state->stopped = true;
+                    return 0;
+                }
+            }
+            if (chunk.value("done", false)) {
+                state->done = true;
+                state->final_chunk = std::move(chunk);
+            }
+        }
+        state->pending.erase(0, start);
+        return total_size;
+    }
+
+    // Polled by CURL while waiting (e.g. during prompt prefill); non-zero aborts the transfer
+    static int StreamProgressCallback(void* userp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+        auto* state = static_cast<StreamState*>(userp);
+        if (state->should_stop && (*state->should_stop)()) {
+            state->stopped = true;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Generation payload shared by the blocking and streaming calls
+    json buildGeneratePayload(const std::string& prompt, const std::string& system_prompt, int max_tokens,
+                              const std::string& keep_alive, bool stream) {
+        json payload;
+        payload["model"] = model_name;
+        payload["prompt"] = prompt;
+        payload["stream"] = stream;
+
+        // Add system prompt if provided
+        if (!system_prompt.empty()) {
+            payload["system"] = system_prompt;
+        }
+
+        if (!keep_alive.empty()) {
+            payload["keep_alive"] = keep_alive;
         }
 
+        // Generation options - use model-specific configuration
+        payload["options"] = json::object();
+        payload["options"]["temperature"] = model_config.temperature;
+        payload["options"]["top_p"] = 0.9;
+        payload["options"]["num_predict"] = max_tokens > 0 ? std::min(max_tokens, model_config.num_predict)
+                                                           : model_config.num_predict;
+        payload["options"]["num_ctx"] = model_config.context_length;
+        return payload;
+    }
+
+    // POST to one backend; records the outcome against its breaker and throws on failure
+    json postTo(OllamaRouter::Backend& backend, const std::string& endpoint, const json& payload) {
+        CurlPool::Handle handle = backend.curl_pool->acquire();
+        CURL* curl = handle.get();
+
         std::string response_data;
-        std::string url = ollama_host + endpoint;
+        std::string url = backend.host + endpoint;
         std::string json_payload = payload.dump();
 
         // Set up CURL options
@@ -45,43 +168,179 @@ private:
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_data);
         curl_easy_setopt(curl, CURLOPT_TIMEOUT, 300L); // 5 minute timeout for LLM generation
-
-        // Set headers
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, backend.curl_pool->jsonHeaders());
 
         // Perform request
         CURLcode res = curl_easy_perform(curl);
 
+        // Check HTTP response code
+        long http_code = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+        router->recordOutcome(backend, res, http_code);
+
         // Check for errors
         if (res != CURLE_OK) {
-            std::string error = "CURL request failed: " + std::string(curl_easy_strerror(res));
-            curl_slist_free_all(headers);
-            curl_easy_cleanup(curl);
-            throw std::runtime_error(error);
+            throw std::runtime_error("CURL request failed: " + std::string(curl_easy_strerror(res)));
         }
 
-        // Check HTTP response code
+        if (http_code != 200) {
+            throw std::runtime_error("HTTP error: " + std::to_string(http_code));
+        }
+
+        return json::parse(response_data);
+    }
+
+    // Make HTTP POST request to Ollama API on the least-loaded healthy backend with the
+    // payload's model, failing over to the next one if it errors
+    json makeRequest(const std::string& endpoint, const json& payload) {
+        std::string model = payload.value("model", "");
+        std::set<const OllamaRouter::Backend*> tried;
+        std::string last_error = "No healthy Ollama backend available";
+
+        while (OllamaRouter::Lease backend = router->acquire(model, tried)) {
+            tried.insert(&*backend);
+            try {
+                json response = postTo(*backend, endpoint, payload);
+                router->recordThroughput(*backend, model, response);
+                return response;
+            } catch (const std::exception& e) {
+                last_error = e.what();
+                std::cerr << "⚠️  " << endpoint << " failed on " << backend->host << ": " << last_error << std::endl;
+            }
+        }
+        throw std::runtime_error(last_error);
+    }
+
+    // Identity of a request for coalescing: model, system prompt, prompt or messages and
+    // options. Whether it streams and how long the model stays loaded don't change the answer.
+    static std::string requestKey(const std::string& endpoint, json payload) {
+        payload.erase("stream");
+        payload.erase("keep_alive");
+        return ContentHash::sha256(endpoint + "\n" + payload.dump());
+    }
+
+    // makeRequest, attached to an identical request already in flight if there is one
+    json coalescedRequest(const std::string& endpoint, const json& payload) {
+        bool joined = false;
+        json response = request_flight.run(requestKey(endpoint, payload),
+                                           [&] { return makeRequest(endpoint, payload); }, &joined);
+        if (joined) {
+            coalesced_requests++;
+            std::cout << "🔗 Shared the result of an identical in-flight " << endpoint << " request" << std::endl;
+        }
+        return response;
+    }
+
+    // Stream from the least-loaded backend, failing over while no token has been delivered
+    std::string streamUpstream(const std::string& json_payload, const TokenCallback& on_token,
+                               const std::function<bool()>& should_stop) {
+        std::set<const OllamaRouter::Backend*> tried;
+        std::string last_error = "No healthy Ollama backend available";
+
+        while (OllamaRouter::Lease backend = router->acquire(model_name, tried)) {
+            tried.insert(&*backend);
+            StreamState state;
+            state.on_token = &on_token;
+            state.should_stop = &should_stop;
+            try {
+                streamFrom(*backend, json_payload, state);
+                return state.output;
+            } catch (const GenerationCancelled&) {
+                throw;
+            } catch (const std::exception& e) {
+                // Tokens already handed to the caller can't be taken back, so only retry a clean failure
+                if (!state.output.empty()) throw;
+                last_error = e.what();
+                std::cerr << "⚠️  Streaming generation failed on " << backend->host << ": " << last_error << std::endl;
+            }
+        }
+        throw std::runtime_error(last_error);
+    }
+
+    // Follow a stream another caller started: replay its output so far, then each new
+    // token until it finishes. Detaching never stops the upstream for the others.
+    std::string followStream(SharedStream& shared, const TokenCallback& on_token,
+                             const std::atomic<bool>* cancelled) {
+        auto detach = [&shared]() {
+            if (--shared.listeners == 0) shared.abandoned = true;
+        };
+
+        std::unique_lock<std::mutex> lock(shared.mutex);
+        size_t sent = 0;
+        while (true) {
+            // Timed so a cancel is noticed even while the upstream is still in prefill
+            shared.updated.wait_for(lock, std::chrono::milliseconds(100),
+                                    [&] { return shared.output.size() > sent || shared.finished; });
+            if (cancelled && cancelled->load()) {
+                detach();
+                throw GenerationCancelled();
+            }
+            if (shared.output.size() > sent) {
+                std::string fragment = shared.output.substr(sent);
+                sent = shared.output.size();
+                lock.unlock();
+                bool keep_going = on_token(fragment);
+                lock.lock();
+                if (!keep_going) {
+                    detach();
+                    throw GenerationCancelled();
+                }
+            } else if (shared.finished) {
+                if (shared.error) std::rethrow_exception(shared.error);
+                return shared.output;
+            }
+        }
+    }
+
+    // One streaming generation on one backend; throws GenerationCancelled or runtime_error
+    void streamFrom(OllamaRouter::Backend& backend, const std::string& json_payload, StreamState& state) {
+        CurlPool::Handle handle = backend.curl_pool->acquire();
+        CURL* curl = handle.get();
+        std::string url = backend.host + "/api/generate";
+
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_payload.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, json_payload.length());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, StreamCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &state);
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, StreamProgressCallback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &state);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 300L);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, backend.curl_pool->jsonHeaders());
+
+        CURLcode res = curl_easy_perform(curl);
+
         long http_code = 0;
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+        // A cancelled transfer says nothing about Ollama; an error line in the stream means it answered
+        if (!state.stopped) router->recordOutcome(backend, state.error.empty() ? res : CURLE_OK, http_code);
 
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
-
+        if (state.stopped) {
+            std::cout << "⏹️  LLM generation cancelled after " << state.output.size() << " bytes" << std::endl;
+            throw GenerationCancelled();
+        }
+        if (!state.error.empty()) {
+            std::cerr << "❌ LLM generation failed: " << state.error << std::endl;
+            throw std::runtime_error("Ollama error: " + state.error);
+        }
+        if (res != CURLE_OK) {
+            std::string error = "CURL request failed: " + std::string(curl_easy_strerror(res));
+            std::cerr << "❌ LLM generation failed: " << error << std::endl;
+            throw std::runtime_error(error);
+        }
         if (http_code != 200) {
             throw std::runtime_error("HTTP error: " + std::to_string(http_code));
         }
-
-        return response_data;
+        if (!state.done) {
+            throw std::runtime_error("Ollama stream ended before generation finished");
+        }
+        router->recordThroughput(backend, model_name, state.final_chunk);
     }
 
 public:
     LLMService() {
-        // Get Ollama host from environment or use default
-        const char* host = std::getenv("OLLAMA_HOST");
-        ollama_host = host ? host : "http://localhost:11434";
-
         std::cout << "\n🔧 Initializing LLM Service..." << std::endl;
         std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
 
@@ -127,13 +386,36 @@ public:
             model_name = model_config.model_name;
         }
 
+        const char* embed_model = std::getenv("OLLAMA_EMBED_MODEL");
+        embedding_model = embed_model ? embed_model : "nomic-embed-text";
+
         std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
         std::cout << "✓ LLM service initialized" << std::endl;
-        std::cout << "  Host: " << ollama_host << std::endl;
         std::cout << "  Model: " << model_name << std::endl;
+        std::cout << "  Embedding model: " << embedding_model << std::endl;
+
+        // Idle connections kept open to each Ollama server between requests
+        const char* pool_size = std::getenv("OLLAMA_POOL_SIZE");
+        const char* interval = std::getenv("OLLAMA_HEALTH_INTERVAL_SEC");
+        const char* failures = std::getenv("OLLAMA_BREAKER_FAILURES");
+        const char* cooldown = std::getenv("OLLAMA_BREAKER_COOLDOWN_SEC");
+        router = std::make_unique<OllamaRouter>(
+            OllamaRouter::hostsFromEnvironment(),
+            pool_size ? std::max(1, std::atoi(pool_size)) : 8,
+            std::chrono::seconds(interval ? std::max(1, std::atoi(interval)) : 15),
+            failures ? std::max(1, std::atoi(failures)) : 3,
+            std::chrono::seconds(cooldown ? std::max(1, std::atoi(cooldown)) : 10));
+
+        for (const auto& backend : router->getBackends()) {
+            std::cout << "  Host: " << backend->host << " ("
+                      << (backend->breaker->allow() ? "available" : "unavailable") << ")" << std::endl;
+        }
         std::cout << std::endl;
     }
 
+    LLMService(const LLMService&) = delete;
+    LLMService& operator=(const LLMService&) = delete;
+
     // Pull a model if not already available
     bool pullModel(const std::string& model = "") {
         std::string target_model = model.empty() ? model_name : model;
@@ -145,7 +427,10 @@ public:
             payload["name"] = target_model;
             payload["stream"] = false;
 
-            makeRequest("/api/pull", payload);
+            // Every backend needs its own copy of the model
+            for (const auto& backend : router->getBackends()) {
+                postTo(*backend, "/api/pull", payload);
+            }
             std::cout << "✅ Model pulled successfully: " << target_model << std::endl;
             return true;
         } catch (const std::exception& e) {
@@ -154,31 +439,16 @@ public:
         }
     }
 
-    // Generate text using the LLM
-    std::string generate(const std::string& prompt, const std::string& system_prompt = "") {
+    // Generate text using the LLM; max_tokens > 0 caps the output below the model's num_predict.
+    // keep_alive (e.g. "10m") asks Ollama to keep the model, and its cached prompt prefix, loaded
+    // after this request instead of falling back to the server default.
+    std::string generate(const std::string& prompt, const std::string& system_prompt = "", int max_tokens = 0,
+                         const std::string& keep_alive = "") {
         try {
-            json payload;
-            payload["model"] = model_name;
-            payload["prompt"] = prompt;
-            payload["stream"] = false;
-
-            // Add system prompt if provided
-            if (!system_prompt.empty()) {
-                payload["system"] = system_prompt;
-            }
-
-            // Generation options - use model-specific configuration
-            payload["options"] = json::object();
-            payload["options"]["temperature"] = model_config.temperature;
-            payload["options"]["top_p"] = 0.9;
-            payload["options"]["num_predict"] = model_config.num_predict;
-            payload["options"]["num_ctx"] = model_config.context_length;
+            json payload = buildGeneratePayload(prompt, system_prompt, max_tokens, keep_alive, false);
 
             std::cout << "🤖 Generating with LLM..." << std::endl;
-            std::string response = makeRequest("/api/generate", payload);
-
-            // Parse response
-            json response_json = json::parse(response);
+            json response_json = coalescedRequest("/api/generate", payload);
 
             if (response_json.contains("response")) {
                 std::cout << "✅ LLM generation complete" << std::endl;
@@ -193,6 +463,113 @@ public:
         }
     }
 
+    // Generate with stream: true, passing each token to on_token as Ollama produces it.
+    // Returns the full text. Throws GenerationCancelled if on_token returns false or
+    // `cancelled` is set (checked while waiting too, so a cancel during prefill is prompt).
+    //
+    // Identical concurrent calls (same model, prompts and options) share one upstream
+    // generation: later callers first receive the tokens produced so far, then the live
+    // stream. The upstream only stops once every attached caller has cancelled, so a
+    // caller that cancels while others still listen keeps its thread until it finishes.
+    std::string generateStream(
+        const std::string& prompt,
+        const std::string& system_prompt,
+        const TokenCallback& on_token,
+        const std::atomic<bool>* cancelled = nullptr,
+        int max_tokens = 0,
+        const std::string& keep_alive = ""
+    ) {
+        json payload = buildGeneratePayload(prompt, system_prompt, max_tokens, keep_alive, true);
+        std::string key = requestKey("/api/generate", payload);
+
+        std::shared_ptr<SharedStream> shared;
+        bool follower = false;
+        {
+            std::lock_guard<std::mutex> lock(streams_mutex);
+            auto it = streams.find(key);
+            if (it != streams.end()) {
+                std::lock_guard<std::mutex> stream_lock(it->second->mutex);
+                if (!it->second->abandoned) {
+                    shared = it->second;
+                    shared->listeners++;
+                    follower = true;
+                }
+            }
+            if (!follower) {
+                shared = std::make_shared<SharedStream>();
+                streams[key] = shared;
+            }
+        }
+        if (follower) {
+            coalesced_requests++;
+            std::cout << "🔗 Attached to an identical in-flight streaming generation" << std::endl;
+            return followStream(*shared, on_token, cancelled);
+        }
+
+        // This caller drives the upstream and is its first listener
+        bool attached = true;
+        auto detach = [&]() {
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            if (!attached) return;
+            attached = false;
+            if (--shared->listeners == 0) shared->abandoned = true;
+        };
+        TokenCallback publish = [&](const std::string& token) {
+            {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                shared->output += token;
+            }
+            shared->updated.notify_all();
+            if (attached && ((cancelled && cancelled->load()) || !on_token(token))) detach();
+            return !shared->abandoned.load();
+        };
+        std::function<bool()> should_stop = [&]() {
+            if (attached && cancelled && cancelled->load()) detach();
+            return shared->abandoned.load();
+        };
+
+        std::string output;
+        std::exception_ptr error;
+        std::cout << "🤖 Streaming generation with LLM..." << std::endl;
+        try {
+            output = streamUpstream(payload.dump(), publish, should_stop);
+            std::cout << "✅ LLM generation complete" << std::endl;
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(streams_mutex);
+            auto it = streams.find(key);
+            if (it != streams.end() && it->second == shared) streams.erase(it);
+        }
+        {
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            shared->finished = true;
+            shared->error = error;
+        }
+        shared->updated.notify_all();
+
+        if (!attached) throw GenerationCancelled();
+        if (error) std::rethrow_exception(error);
+        return output;
+    }
+
+    // Embed a batch of texts with the embedding model in one /api/embed request.
+    // Returns one vector per input, in input order.
+    std::vector<std::vector<float>> embed(const std::vector<std::string>& inputs) {
+        json payload;
+        payload["model"] = embedding_model;
+        payload["input"] = inputs;
+        payload["truncate"] = true;
+
+        json response_json = makeRequest("/api/embed", payload);
+        if (!response_json.contains("embeddings") || response_json["embeddings"].size() != inputs.size()) {
+            throw std::runtime_error("Invalid embedding response from Ollama");
+        }
+        return response_json["embeddings"].get<std::vector<std::vector<float>>>();
+    }
+
     // Chat-based generation (for multi-turn conversations)
     std::string chat(const std::vector<std::pair<std::string, std::string>>& messages,
                      const std::string& system_prompt = "") {
@@ -223,10 +600,7 @@ public:
             payload["messages"] = messages_array;
 
             std::cout << "🤖 Generating chat response with LLM..." << std::endl;
-            std::string response = makeRequest("/api/chat", payload);
-
-            // Parse response
-            json response_json = json::parse(response);
+            json response_json = coalescedRequest("/api/chat", payload);
 
             if (response_json.contains("message") &&
                 response_json["message"].contains("content")) {
@@ -242,27 +616,22 @@ public:
         }
     }
 
-    // Check if Ollama service is available
+    // Probe every Ollama backend now with a blocking request and record the results;
+    // true if any is healthy. Request paths should use isAvailable() instead.
     bool checkHealth() {
-        try {
-            CURL* curl = curl_easy_init();
-            if (!curl) return false;
-
-            std::string response;
-            std::string url = ollama_host + "/api/tags";
-
-            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L);
+        return router->probeAll();
+    }
 
-            CURLcode res = curl_easy_perform(curl);
-            curl_easy_cleanup(curl);
+    // Cached availability from the backends' circuit breakers; never blocks
+    bool isAvailable() const {
+        return router->isAvailable();
+    }
 
-            return (res == CURLE_OK);
-        } catch (...) {
-            return false;
-        }
+    // Breaker state, load, models and speed of each backend for the health endpoint
+    json getHealth() const {
+        json health = router->getStatus();
+        health["coalesced_requests"] = coalesced_requests.load();
+        return health;
     }
 
     // Set model to use
@@ -276,6 +645,11 @@ public:
         return model_name;
     }
 
+    // Get the model used for embeddings
+    std::string getEmbeddingModel() const {
+        return embedding_model;
+    }
+
     // Get system specifications
     SystemSpecs getSystemSpecs() const {
         return system_specs;
@@ -0,0 +1,390 @@
+#ifndef OLLAMA_ROUTER_H
+#define OLLAMA_ROUTER_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <curl/curl.h>
+#include "../utils/CurlPool.h"
+#include "../utils/CircuitBreaker.h"
+
+using json = nlohmann::json;
+
+// Spreads Ollama requests over one or more servers. Each backend has its own
+// connection pool and circuit breaker, a count of requests in flight, the models
+// it reported on its last probe, and a moving average of generation speed per
+// model. A request goes to the healthy backend with the model that would finish
+// it soonest: (in flight + 1) / tokens per second. A background prober refreshes
+// health and model lists; request outcomes feed the breakers too.
+class OllamaRouter {
+public:
+    struct Backend {
+        std::string host;
+        std::unique_ptr<CurlPool> curl_pool;
+        std::unique_ptr<CircuitBreaker> breaker;
+        size_t in_flight = 0;                           // guarded by the router's route_mutex
+        std::atomic<size_t> requests{0};
+        std::atomic<size_t> failures{0};
+        std::chrono::steady_clock::time_point next_probe_at;   // owned by the prober thread
+
+        mutable std::mutex mutex;
+        bool models_known = false;                      // set by the first successful probe
+        std::set<std::string> models;
+        std::map<std::string, double> tokens_per_sec;   // model -> moving average
+    };
+
+    // A backend reserved for one request; releases its in-flight slot when destroyed
+    class Lease {
+    public:
+        Lease(OllamaRouter* router, Backend* backend) : router(router), backend(backend) {}
+        Lease(Lease&& other) noexcept : router(other.router), backend(other.backend) { other.backend = nullptr; }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+        ~Lease() {
+            if (backend) router->release(*backend);
+        }
+
+        Backend* operator->() const { return backend; }
+        Backend& operator*() const { return *backend; }
+        explicit operator bool() const { return backend != nullptr; }
+
+    private:
+        OllamaRouter* router;
+        Backend* backend;
+    };
+
+private:
+    std::vector<std::unique_ptr<Backend>> backends;
+    std::mutex route_mutex;
+    std::chrono::seconds health_interval;
+
+    std::mutex health_mutex;
+    std::condition_variable health_wakeup;
+    std::atomic<bool> stopping{false};
+    std::thread health_prober;
+
+    // Weight of the newest observation in the per-model speed average
+    static constexpr double THROUGHPUT_SMOOTHING = 0.3;
+
+    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
+        size_t total_size = size * nmemb;
+        userp->append(static_cast<char*>(contents), total_size);
+        return total_size;
+    }
+
+    // "llama3" and "llama3:latest" name the same model
+    static std::string normalizeModel(const std::string& model) {
+        const std::string suffix = ":latest";
+        if (model.size() > suffix.size() && model.compare(model.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            return model.substr(0, model.size() - suffix.size());
+        }
+        return model;
+    }
+
+    // Whether the backend should receive requests for the model; unknown model lists count as yes
+    static bool hasModel(const Backend& backend, const std::string& model) {
+        std::lock_guard<std::mutex> lock(backend.mutex);
+        return !backend.models_known || model.empty() || backend.models.count(normalizeModel(model)) > 0;
+    }
+
+    static double throughput(const Backend& backend, const std::string& model) {
+        std::lock_guard<std::mutex> lock(backend.mutex);
+        auto it = backend.tokens_per_sec.find(normalizeModel(model));
+        return it != backend.tokens_per_sec.end() ? it->second : 0.0;
+    }
+
+    void release(Backend& backend) {
+        std::lock_guard<std::mutex> lock(route_mutex);
+        backend.in_flight--;
+    }
+
+    // Feed one observation into a backend's breaker, logging when its availability changes
+    void reportHealth(Backend& backend, bool ok, const std::string& error = "") {
+        bool was_available = backend.breaker->allow();
+        if (ok) {
+            backend.breaker->recordSuccess();
+        } else {
+            backend.failures++;
+            backend.breaker->recordFailure(error);
+        }
+        bool available = backend.breaker->allow();
+        if (was_available && !available) {
+            std::cerr << "🔌 LLM backend " << backend.host << " marked unavailable: " << error << std::endl;
+        } else if (!was_available && available) {
+            std::cout << "✅ LLM backend " << backend.host << " available again" << std::endl;
+        }
+    }
+
+    // Probe due backends concurrently, so one hung server doesn't delay the others
+    void healthLoop() {
+        std::unique_lock<std::mutex> lock(health_mutex);
+        while (!stopping) {
+            auto now = std::chrono::steady_clock::now();
+            auto next = now + health_interval;
+            for (const auto& backend : backends) {
+                bool open = backend->breaker->current() == CircuitBreaker::State::Open;
+                next = std::min(next, open ? backend->breaker->snapshot().retry_at : backend->next_probe_at);
+            }
+            health_wakeup.wait_until(lock, next, [this] { return stopping.load(); });
+            if (stopping) return;
+
+            now = std::chrono::steady_clock::now();
+            std::vector<Backend*> due;
+            for (const auto& backend : backends) {
+                if (backend->breaker->current() == CircuitBreaker::State::Open) {
+                    // The probe is the half-open trial
+                    if (backend->breaker->tryHalfOpen()) due.push_back(backend.get());
+                } else if (backend->next_probe_at <= now) {
+                    due.push_back(backend.get());
+                }
+            }
+
+            lock.unlock();
+            std::vector<std::future<bool>> probes;
+            for (Backend* backend : due) {
+                probes.push_back(std::async(std::launch::async, [this, backend] { return probe(*backend); }));
+            }
+            for (auto& result : probes) result.wait();
+            lock.lock();
+
+            auto next_probe_at = std::chrono::steady_clock::now() + health_interval;
+            for (Backend* backend : due) backend->next_probe_at = next_probe_at;
+        }
+    }
+
+public:
+    OllamaRouter(const std::vector<std::string>& hosts, size_t pool_size, std::chrono::seconds health_interval,
+                 size_t failure_threshold, std::chrono::seconds cooldown)
+        : health_interval(health_interval) {
+        if (hosts.empty()) {
+            throw std::runtime_error("No Ollama hosts configured");
+        }
+        for (const auto& host : hosts) {
+            auto backend = std::make_unique<Backend>();
+            backend->host = host;
+            backend->curl_pool = std::make_unique<CurlPool>(pool_size);
+            backend->breaker = std::make_unique<CircuitBreaker>(failure_threshold, cooldown);
+            backend->next_probe_at = std::chrono::steady_clock::now() + health_interval;
+            backends.push_back(std::move(backend));
+        }
+
+        // One blocking probe of every backend at startup; unreachable ones start with their breaker open
+        std::vector<std::future<bool>> probes;
+        for (const auto& backend : backends) {
+            Backend* target = backend.get();
+            probes.push_back(std::async(std::launch::async, [this, target] { return probe(*target); }));
+        }
+        for (size_t i = 0; i < backends.size(); ++i) {
+            if (!probes[i].get()) backends[i]->breaker->trip();
+        }
+        health_prober = std::thread(&OllamaRouter::healthLoop, this);
+    }
+
+    ~OllamaRouter() {
+        stopping = true;
+        health_wakeup.notify_all();
+        if (health_prober.joinable()) health_prober.join();
+    }
+
+    OllamaRouter(const OllamaRouter&) = delete;
+    OllamaRouter& operator=(const OllamaRouter&) = delete;
+
+    // Comma-separated OLLAMA_HOSTS, else OLLAMA_HOST, else the local default
+    static std::vector<std::string> hostsFromEnvironment() {
+        std::vector<std::string> hosts;
+        const char* list = std::getenv("OLLAMA_HOSTS");
+        if (list) {
+            std::string value = list;
+            size_t start = 0;
+            while (start <= value.size()) {
+                size_t comma = value.find(',', start);
+                if (comma == std::string::npos) comma = value.size();
+                std::string host = value.substr(start, comma - start);
+                host.erase(0, host.find_first_not_of(" \t"));
+                host.erase(host.find_last_not_of(" \t/") + 1);
+                if (!host.empty() && std::find(hosts.begin(), hosts.end(), host) == hosts.end()) {
+                    hosts.push_back(host);
+                }
+                start = comma + 1;
+            }
+        }
+        if (hosts.empty()) {
+            const char* host = std::getenv("OLLAMA_HOST");
+            hosts.push_back(host ? host : "http://localhost:11434");
+        }
+        return hosts;
+    }
+
+    // Reserve the backend that should serve a request for model, skipping those in
+    // `exclude` (already tried). Backends with the model beat those without; among
+    // equals the lowest (in flight + 1) / tokens per second wins, with backends that
+    // have no speed sample yet assumed to match the average of those that do.
+    // Returns an empty lease when no healthy backend is left.
+    Lease acquire(const std::string& model, const std::set<const Backend*>& exclude = {}) {
+        double known_total = 0;
+        size_t known_count = 0;
+        for (const auto& backend : backends) {
+            double speed = throughput(*backend, model);
+            if (speed > 0) {
+                known_total += speed;
+                known_count++;
+            }
+        }
+        double default_speed = known_count > 0 ? known_total / known_count : 1.0;
+
+        std::lock_guard<std::mutex> lock(route_mutex);
+        Backend* best = nullptr;
+        bool best_has_model = false;
+        double best_cost = 0;
+        for (const auto& backend : backends) {
+            if (exclude.count(backend.get()) || !backend->breaker->allow()) continue;
+            bool has_model = hasModel(*backend, model);
+            double speed = throughput(*backend, model);
+            double cost = (backend->in_flight + 1) / (speed > 0 ? speed : default_speed);
+            if (!best || (has_model && !best_has_model) || (has_model == best_has_model && cost < best_cost)) {
+                best = backend.get();
+                best_has_model = has_model;
+                best_cost = cost;
+            }
+        }
+        if (best) {
+            best->in_flight++;
+            best->requests++;
+        }
+        return Lease(this, best);
+    }
+
+    // Transport failures and server errors count against a backend; client errors such as an unknown model don't
+    void recordOutcome(Backend& backend, CURLcode res, long http_code) {
+        if (res != CURLE_OK) {
+            reportHealth(backend, false, "CURL request failed: " + std::string(curl_easy_strerror(res)));
+        } else if (http_code >= 500) {
+            reportHealth(backend, false, "HTTP error: " + std::to_string(http_code));
+        } else {
+            reportHealth(backend, true);
+        }
+    }
+
+    // Fold a finished generation's eval_count / eval_duration into the backend's speed for the model
+    void recordThroughput(Backend& backend, const std::string& model, const json& response) {
+        long long tokens = response.value("eval_count", 0LL);
+        long long duration_ns = response.value("eval_duration", 0LL);
+        if (tokens <= 0 || duration_ns <= 0) return;
+
+        double speed = tokens / (duration_ns / 1e9);
+        std::lock_guard<std::mutex> lock(backend.mutex);
+        auto [it, inserted] = backend.tokens_per_sec.emplace(normalizeModel(model), speed);
+        if (!inserted) it->second += THROUGHPUT_SMOOTHING * (speed - it->second);
+    }
+
+    // Probe a backend now with a blocking /api/tags request, recording its health and models
+    bool probe(Backend& backend) {
+        try {
+            CurlPool::Handle handle = backend.curl_pool->acquire();
+            CURL* curl = handle.get();
+
+            std::string response;
+            std::string url = backend.host + "/api/tags";
+
+            curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 5L);
+
+            CURLcode res = curl_easy_perform(curl);
+
+            long http_code = 0;
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+            recordOutcome(backend, res, http_code);
+            if (res != CURLE_OK || http_code >= 500) return false;
+
+            json tags = json::parse(response, nullptr, false);
+            if (!tags.is_discarded() && tags.contains("models") && tags["models"].is_array()) {
+                std::set<std::string> models;
+                for (const auto& model : tags["models"]) {
+                    std::string name = model.value("name", model.value("model", ""));
+                    if (!name.empty()) models.insert(normalizeModel(name));
+                }
+                std::lock_guard<std::mutex> lock(backend.mutex);
+                backend.models = std::move(models);
+                backend.models_known = true;
+            }
+            return true;
+        } catch (const std::exception& e) {
+            reportHealth(backend, false, e.what());
+            return false;
+        }
+    }
+
+    // Probe every backend; true if any is healthy
+    bool probeAll() {
+        bool any = false;
+        for (const auto& backend : backends) any = probe(*backend) || any;
+        return any;
+    }
+
+    // Whether any backend's breaker is closed; never blocks
+    bool isAvailable() const {
+        for (const auto& backend : backends) {
+            if (backend->breaker->allow()) return true;
+        }
+        return false;
+    }
+
+    const std::vector<std::unique_ptr<Backend>>& getBackends() const {
+        return backends;
+    }
+
+    // Per-backend breaker state, load, models and speeds for the health endpoint
+    json getStatus() {
+        auto now = std::chrono::steady_clock::now();
+        auto millis = [](std::chrono::steady_clock::duration d) {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+        };
+
+        json status;
+        status["available"] = isAvailable();
+        status["backends"] = json::array();
+        for (const auto& backend : backends) {
+            auto snapshot = backend->breaker->snapshot();
+            json entry;
+            entry["host"] = backend->host;
+            entry["available"] = snapshot.state == CircuitBreaker::State::Closed;
+            entry["circuit"] = CircuitBreaker::stateName(snapshot.state);
+            entry["consecutive_failures"] = snapshot.consecutive_failures;
+            entry["times_opened"] = snapshot.times_opened;
+            entry["state_age_ms"] = millis(now - snapshot.changed_at);
+            if (snapshot.state == CircuitBreaker::State::Open) {
+                entry["retry_in_ms"] = std::max<long long>(0, millis(snapshot.retry_at - now));
+            }
+            if (!snapshot.last_error.empty()) entry["last_error"] = snapshot.last_error;
+            {
+                std::lock_guard<std::mutex> lock(route_mutex);
+                entry["in_flight"] = backend->in_flight;
+            }
+            entry["requests"] = backend->requests.load();
+            entry["failures"] = backend->failures.load();
+            {
+                std::lock_guard<std::mutex> lock(backend->mutex);
+                if (backend->models_known) entry["models"] = backend->models;
+                entry["tokens_per_sec"] = backend->tokens_per_sec;
+            }
+            status["backends"].push_back(entry);
+        }
+        return status;
+    }
+};
+
+#endif // OLLAMA_ROUTER_H
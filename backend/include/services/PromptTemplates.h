@@ -3,9 +3,14 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <sstream>
 
 class PromptTemplates {
 public:
+    // Bump whenever prompt wording changes so cached documentation is regenerated
+    static constexpr int VERSION = 4;
+
     // System prompts for different documentation contexts
     static std::string getSystemPrompt(const std::string& doc_type) {
         static const std::map<std::string, std::string> system_prompts = {
@@ -163,19 +168,29 @@ public:
                "and well-structured documentation in Markdown format.";
     }
 
-    // Generate context-aware prompt with repository data
+    // Generate context-aware prompt with repository data. The repository context comes
+    // first and the task-specific text last, so prompts for different doc types over the
+    // same repository share a prefix that Ollama can reuse from its KV cache.
     static std::string buildPrompt(
         const std::string& doc_type,
         const std::string& audience,
         const std::string& repo_overview,
         const std::string& file_structure,
         const std::string& key_files_summary
+    ) {
+        return buildContextPrefix(repo_overview, file_structure, key_files_summary) +
+               buildTaskSuffix(doc_type, audience);
+    }
+
+    // Shared part of every documentation prompt for one repository
+    static std::string buildContextPrefix(
+        const std::string& repo_overview,
+        const std::string& file_structure,
+        const std::string& key_files_summary
     ) {
         std::ostringstream prompt;
 
-        prompt << "# Documentation Generation Task\n\n";
-        prompt << "**Documentation Type:** " << doc_type << "\n";
-        prompt << "**Target Audience:** " << audience << "\n\n";
+        prompt << "# Repository Context\n\n";
 
         prompt << "## Repository Overview\n\n";
         prompt << repo_overview << "\n\n";
@@ -187,6 +202,26 @@ public:
         prompt << key_files_summary << "\n\n";
 
         prompt << "---\n\n";
+
+        return prompt.str();
+    }
+
+    // Doc-type specific part of the prompt. With include_role set, the doc type's system
+    // prompt is inlined here so a batch can share one generic system prompt.
+    static std::string buildTaskSuffix(
+        const std::string& doc_type,
+        const std::string& audience,
+        bool include_role = false
+    ) {
+        std::ostringstream prompt;
+
+        prompt << "# Documentation Generation Task\n\n";
+        if (include_role) {
+            prompt << "**Role:** " << getSystemPrompt(doc_type) << "\n\n";
+        }
+        prompt << "**Documentation Type:** " << doc_type << "\n";
+        prompt << "**Target Audience:** " << audience << "\n\n";
+
         prompt << "Based on the above information, generate comprehensive "
                << doc_type << " documentation.\n\n";
 
@@ -196,6 +231,188 @@ public:
         return prompt.str();
     }
 
+    // One "## " section of a doc type's outline
+    struct DocumentSection {
+        std::string title;
+        std::string outline;    // the section's lines from the outline, heading included
+    };
+
+    // Document title ("# API Documentation") and its "## " sections, in outline order.
+    // Headings inside fenced code blocks belong to the surrounding section.
+    static std::string getDocumentTitle(const std::string& doc_type, const std::string& audience) {
+        std::istringstream lines(getSpecificInstructions(doc_type, audience));
+        for (std::string line; std::getline(lines, line);) {
+            if (line.rfind("# ", 0) == 0) return line.substr(2);
+        }
+        return "";
+    }
+
+    static std::vector<DocumentSection> getDocumentSections(const std::string& doc_type, const std::string& audience) {
+        std::vector<DocumentSection> sections;
+        std::istringstream lines(getSpecificInstructions(doc_type, audience));
+        bool in_outline = false;
+        bool in_code = false;
+
+        for (std::string line; std::getline(lines, line);) {
+            if (line.rfind("```", 0) == 0) in_code = !in_code;
+            if (!in_code && line.rfind("# ", 0) == 0) {
+                in_outline = true;
+                continue;
+            }
+            if (!in_outline) continue;
+
+            if (!in_code && line.rfind("## ", 0) == 0) {
+                sections.push_back({line.substr(3), ""});
+            }
+            if (!sections.empty()) {
+                sections.back().outline += line + "\n";
+            }
+        }
+        if (!sections.empty()) return sections;
+
+        // Doc types without a detailed outline name their sections in the system prompt
+        // ("Structure as: Overview → Authentication → ... .")
+        std::string system_prompt = getSystemPrompt(doc_type);
+        size_t start = system_prompt.find("Structure as: ");
+        if (start == std::string::npos) return sections;
+        start += 14;
+        size_t end = system_prompt.find(". ", start);
+        std::string structure = system_prompt.substr(start, end == std::string::npos ? std::string::npos : end - start);
+
+        const std::string arrow = " → ";
+        for (size_t pos = 0; pos <= structure.size();) {
+            size_t next = structure.find(arrow, pos);
+            std::string title = structure.substr(pos, next == std::string::npos ? std::string::npos : next - pos);
+            if (!title.empty() && title.back() == '.') title.pop_back();
+            if (!title.empty() && title.front() != '[') {
+                sections.push_back({title, "## " + title + "\n"});
+            }
+            if (next == std::string::npos) break;
+            pos = next + arrow.size();
+        }
+        return sections;
+    }
+
+    // Task suffix for generating one section on its own, after the shared context prefix or,
+    // with a scope, a context narrowed to the component categories the section covers
+    static std::string buildSectionSuffix(
+        const std::string& doc_type,
+        const std::string& audience,
+        const std::string& document_title,
+        const DocumentSection& section,
+        const std::vector<DocumentSection>& all_sections,
+        const std::vector<std::string>& scope = {}
+    ) {
+        std::ostringstream prompt;
+
+        prompt << "# Documentation Section Task\n\n";
+        prompt << "**Documentation Type:** " << doc_type << "\n";
+        prompt << "**Target Audience:** " << audience << "\n";
+        prompt << "**Document:** " << document_title << "\n\n";
+
+        prompt << "The document is written one section at a time. Its sections are:\n";
+        for (const auto& other : all_sections) {
+            prompt << "- " << other.title << (other.title == section.title ? " (this section)" : "") << "\n";
+        }
+        prompt << "\n";
+
+        if (!scope.empty()) {
+            prompt << "The repository context above is limited to the components this section is about (";
+            for (size_t i = 0; i < scope.size(); ++i) {
+                prompt << scope[i] << (i + 1 < scope.size() ? ", " : "");
+            }
+            prompt << "); the rest of the repository is covered by the other sections.\n\n";
+        }
+
+        prompt << "Based on the above information, write only the \"" << section.title
+               << "\" section. Start with the heading `## " << section.title
+               << "`, do not add a document title, and do not cover topics that belong to the "
+                  "other sections.\n\n";
+
+        prompt << "## Section Outline:\n\n";
+        prompt << section.outline << "\n";
+
+        return prompt.str();
+    }
+
+    // What the files a doc type draws on are about, as a query for embedding retrieval
+    static std::string getRetrievalQuery(const std::string& doc_type) {
+        static const std::map<std::string, std::string> queries = {
+            {"api_documentation", "HTTP API endpoints, routes, request handlers, controllers, authentication, "
+                                  "request and response payloads, error responses"},
+            {"database_documentation", "database schema, tables, models, entities, migrations, queries, "
+                                       "ORM mappings, repositories and data access"},
+            {"architecture_documentation", "application entry points, core services, module boundaries, "
+                                           "dependency wiring, data flow between components"},
+            {"developer_onboarding", "project setup, build configuration, entry points, core services, "
+                                     "development scripts and tests"},
+            {"code_conventions", "shared utilities, base classes, naming patterns, linting and formatting "
+                                 "configuration, test helpers"},
+            {"technical_specification", "core business logic, data models, interfaces, external integrations, "
+                                        "security and performance critical code"},
+            {"user_manual", "user-facing features, commands, user interface, workflows and settings"},
+            {"installation_guide", "installation, build and deployment configuration, environment variables, "
+                                   "dependencies, Dockerfiles and startup scripts"},
+            {"faq", "user-facing features, configuration options, common errors and setup"},
+            {"troubleshooting_guide", "error handling, exceptions, logging, health checks, retries and "
+                                      "configuration validation"},
+            {"release_notes", "recently changed features, public interfaces, configuration and migrations"},
+            {"integration_guide", "public API, SDK clients, webhooks, authentication, external service "
+                                  "integrations and rate limiting"}
+        };
+        auto it = queries.find(doc_type);
+        return it != queries.end() ? it->second
+                                   : "main components, entry points, core services and data models";
+    }
+
+    // System prompt for map/reduce steps that condense parts of a repository
+    static std::string getSummarizerSystemPrompt() {
+        return "You are a senior software engineer summarizing source code for other engineers. "
+               "Be factual and concise. Only describe what the provided analysis supports. "
+               "Write plain Markdown without a top-level title.";
+    }
+
+    // Map step: summarize one directory/module from its packed context
+    static std::string buildModuleSummaryPrompt(
+        const std::string& module_name,
+        const std::string& file_structure,
+        const std::string& key_files_summary
+    ) {
+        std::ostringstream prompt;
+
+        prompt << "# Module Summary Task\n\n";
+        prompt << "**Module:** " << module_name << "\n\n";
+
+        prompt << "## Files\n\n";
+        prompt << file_structure << "\n\n";
+
+        prompt << "## Key Files and Components\n\n";
+        prompt << key_files_summary << "\n\n";
+
+        prompt << "---\n\n";
+        prompt << "Summarize this module in at most 200 words: its responsibility, its main "
+                  "components (classes, functions, entry points), the interfaces it exposes, and "
+                  "the other modules or libraries it depends on.\n";
+
+        return prompt.str();
+    }
+
+    // Reduce step: merge several module summaries into one shorter summary
+    static std::string buildMergeSummariesPrompt(const std::string& summaries) {
+        std::ostringstream prompt;
+
+        prompt << "# Summary Consolidation Task\n\n";
+        prompt << "## Module Summaries\n\n";
+        prompt << summaries << "\n\n";
+
+        prompt << "---\n\n";
+        prompt << "Combine the module summaries above into one summary of at most 300 words. "
+                  "Keep every module name, group related modules together, and preserve the "
+                  "most important components, interfaces and dependencies.\n";
+
+        return prompt.str();
+    }
+
 private:
     static std::string getSpecificInstructions(const std::string& doc_type, const std::string& audience) {
         static const std::map<std::string, std::string> instructions = {
@@ -0,0 +1,283 @@
+#ifndef REPOSITORY_STORE_H
+#define REPOSITORY_STORE_H
+
+#include <string>
+#include <map>
+#include <set>
+#include <mutex>
+#include <shared_mutex>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include "../utils/RepositoryLocks.h"
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+// Tracks every working tree under REPOS_PATH (size, last access, how to
+// recreate it) and keeps their total size under REPOS_QUOTA_MB by deleting the
+// least recently used checkouts. Summaries are never touched, so documentation
+// keeps working; an evicted checkout is re-materialized on its next use.
+class RepositoryStore {
+public:
+    using Materializer = std::function<std::map<std::string, std::string>(
+        const std::string& url, const std::string& branch, const std::string& checkout_mode)>;
+
+private:
+    struct CheckoutEntry {
+        std::string local_path;
+        std::string url;
+        std::string branch;
+        std::string checkout_mode;
+        long long size_bytes = 0;
+        long long last_access = 0;   // seconds since epoch
+        bool evicted = false;
+    };
+
+    std::string index_path;
+    long long quota_bytes;
+    std::mutex mutex;
+    std::map<std::string, CheckoutEntry> entries;
+    Materializer materializer;
+    long long evictions = 0;
+    long long bytes_reclaimed = 0;
+    long long rematerializations = 0;
+
+    static long long nowSeconds() {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    static long long directorySize(const std::string& path) {
+        long long total = 0;
+        std::error_code ec;
+        for (auto it = fs::recursive_directory_iterator(path, fs::directory_options::skip_permission_denied, ec);
+             !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file(ec) && !it->is_symlink(ec)) {
+                total += static_cast<long long>(it->file_size(ec));
+            }
+        }
+        return total;
+    }
+
+    long long usedBytes() const {
+        long long used = 0;
+        for (const auto& [_, entry] : entries) {
+            if (!entry.evicted) used += entry.size_bytes;
+        }
+        return used;
+    }
+
+    // Persist the index (caller holds the mutex)
+    void save() {
+        json index = json::object();
+        for (const auto& [repo_id, entry] : entries) {
+            index[repo_id] = {
+                {"local_path", entry.local_path},
+                {"url", entry.url},
+                {"branch", entry.branch},
+                {"checkout_mode", entry.checkout_mode},
+                {"size_bytes", entry.size_bytes},
+                {"last_access", entry.last_access},
+                {"evicted", entry.evicted}
+            };
+        }
+
+        std::string tmp_path = index_path + ".tmp";
+        std::ofstream out(tmp_path);
+        out << index.dump(2);
+        out.close();
+        fs::rename(tmp_path, index_path);
+    }
+
+    void load() {
+        if (!fs::exists(index_path)) return;
+
+        try {
+            std::ifstream file(index_path);
+            json index;
+            file >> index;
+
+            for (auto& [repo_id, value] : index.items()) {
+                CheckoutEntry entry;
+                entry.local_path = value.value("local_path", "");
+                entry.url = value.value("url", "");
+                entry.branch = value.value("branch", "main");
+                entry.checkout_mode = value.value("checkout_mode", "");
+                entry.size_bytes = value.value("size_bytes", 0LL);
+                entry.last_access = value.value("last_access", 0LL);
+                entry.evicted = value.value("evicted", false) || !fs::exists(entry.local_path);
+                entries[repo_id] = entry;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "⚠ Ignoring unreadable repository store index: " << e.what() << std::endl;
+        }
+    }
+
+    // Evict least recently used checkouts until usage fits the quota (caller holds the mutex).
+    // Checkouts that are being cloned or scanned right now are skipped.
+    void enforceQuota(const std::string& keep_repo_id) {
+        if (quota_bytes <= 0) return;
+
+        bool changed = false;
+        std::set<std::string> skipped = {keep_repo_id};
+        while (usedBytes() > quota_bytes) {
+            std::string victim;
+            long long oldest = 0;
+            for (const auto& [repo_id, entry] : entries) {
+                if (entry.evicted || skipped.count(repo_id)) continue;
+                if (victim.empty() || entry.last_access < oldest) {
+                    victim = repo_id;
+                    oldest = entry.last_access;
+                }
+            }
+            if (victim.empty()) break;
+
+            std::unique_lock<std::shared_mutex> repo_lock(RepositoryLocks::forRepo(victim), std::try_to_lock);
+            CheckoutEntry& entry = entries[victim];
+            if (!repo_lock.owns_lock()) {
+                // In use right now: leave it and consider the next candidate
+                skipped.insert(victim);
+                continue;
+            }
+
+            std::error_code ec;
+            fs::remove_all(entry.local_path, ec);
+            if (ec) {
+                std::cerr << "⚠ Failed to evict " << entry.local_path << ": " << ec.message() << std::endl;
+                skipped.insert(victim);
+                continue;
+            }
+
+            std::cout << "🧹 Evicted checkout " << victim << " (" << entry.size_bytes / (1024 * 1024)
+                      << " MB, summary kept)" << std::endl;
+            evictions++;
+            bytes_reclaimed += entry.size_bytes;
+            entry.evicted = true;
+            changed = true;
+        }
+
+        if (changed) save();
+    }
+
+public:
+    RepositoryStore() {
+        const char* repos_path = std::getenv("REPOS_PATH");
+        std::string base_path = repos_path ? repos_path : "./data/repositories";
+        fs::create_directories(base_path);
+        index_path = base_path + "/.store-index.json";
+
+        const char* quota = std::getenv("REPOS_QUOTA_MB");
+        quota_bytes = quota ? std::atoll(quota) * 1024 * 1024 : 0;
+
+        load();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        std::cout << "✓ Repository store: " << entries.size() << " checkouts, "
+                  << usedBytes() / (1024 * 1024) << " MB used, quota "
+                  << (quota_bytes > 0 ? std::to_string(quota_bytes / (1024 * 1024)) + " MB" : "unlimited")
+                  << std::endl;
+    }
+
+    // How an evicted checkout is recreated (normally a clone through the fetch scheduler)
+    void setMaterializer(Materializer fn) {
+        std::lock_guard<std::mutex> lock(mutex);
+        materializer = std::move(fn);
+    }
+
+    // Record a clone/pull: re-measure the checkout, mark it most recently used and enforce the quota
+    void recordCheckout(const std::map<std::string, std::string>& metadata) {
+        auto local_path = metadata.find("local_path");
+        if (local_path == metadata.end() || local_path->second.empty()) return;
+
+        const std::string& repo_id = metadata.at("repo_id");
+        long long size = directorySize(local_path->second);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        CheckoutEntry& entry = entries[repo_id];
+        entry.local_path = local_path->second;
+        entry.url = metadata.count("github_url") ? metadata.at("github_url") : entry.url;
+        entry.branch = metadata.count("branch") ? metadata.at("branch") : entry.branch;
+        entry.checkout_mode = metadata.count("checkout_mode") ? metadata.at("checkout_mode") : entry.checkout_mode;
+        entry.size_bytes = size;
+        entry.last_access = nowSeconds();
+        entry.evicted = false;
+
+        enforceQuota(repo_id);
+        save();
+    }
+
+    // Record a read of an existing checkout (e.g. a scan)
+    void recordAccess(const std::string& repo_id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(repo_id);
+        if (it == entries.end()) return;
+
+        it->second.last_access = nowSeconds();
+        save();
+    }
+
+    // Local path of a checkout, cloning it again first if it was evicted.
+    // Returns an empty string for repositories the store doesn't manage.
+    std::string ensureMaterialized(const std::string& repo_id) {
+        CheckoutEntry entry;
+        Materializer materialize;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = entries.find(repo_id);
+            if (it == entries.end()) return "";
+            if (!it->second.evicted && fs::exists(it->second.local_path)) {
+                it->second.last_access = nowSeconds();
+                return it->second.local_path;
+            }
+            entry = it->second;
+            materialize = materializer;
+        }
+
+        if (!materialize) {
+            throw std::runtime_error("Checkout " + repo_id + " was evicted and no materializer is configured");
+        }
+
+        std::cout << "♻️  Re-materializing evicted checkout " << repo_id << std::endl;
+        auto metadata = materialize(entry.url, entry.branch, entry.checkout_mode);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        rematerializations++;
+        return metadata.count("local_path") ? metadata.at("local_path") : entry.local_path;
+    }
+
+    // Occupancy and eviction counters
+    json getStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        json stats;
+
+        json checkouts = json::array();
+        size_t resident = 0;
+        for (const auto& [repo_id, entry] : entries) {
+            if (!entry.evicted) resident++;
+            checkouts.push_back({
+                {"repo_id", repo_id},
+                {"url", entry.url},
+                {"branch", entry.branch},
+                {"size_bytes", entry.size_bytes},
+                {"last_access", entry.last_access},
+                {"evicted", entry.evicted}
+            });
+        }
+
+        stats["quota_bytes"] = quota_bytes;
+        stats["used_bytes"] = usedBytes();
+        stats["checkouts"] = checkouts;
+        stats["resident_checkouts"] = resident;
+        stats["evicted_checkouts"] = entries.size() - resident;
+        stats["evictions"] = evictions;
+        stats["bytes_reclaimed"] = bytes_reclaimed;
+        stats["rematerializations"] = rematerializations;
+        return stats;
+    }
+};
+
+#endif // REPOSITORY_STORE_H
@@ -12,7 +12,21 @@
 #include <algorithm>
 #include <iostream>
 #include <nlohmann/json.hpp>
+#include <shared_mutex>
 #include "GitHubService.h"
+#include "../utils/SingleFlight.h"
+#include "../utils/RepositoryLocks.h"
+#include "../utils/LanguageRegistry.h"
+#include "../utils/GitObjectReader.h"
+#include "../utils/ArchiveReader.h"
+#include "../utils/SummaryCache.h"
+#include "../utils/ContentHash.h"
+#include "../utils/TempPath.h"
+#include "../utils/ContextBuilder.h"
+#include "../utils/FileCategorizer.h"
+#include "../utils/MinHash.h"
+#include "RepositoryStore.h"
+#include "EmbeddingService.h"
 
 namespace fs = std::filesystem;
 using json = nlohmann::json;
@@ -20,14 +34,19 @@ using json = nlohmann::json;
 class ScannerService {
 private:
     std::string summaries_path;
-    
-    // Supported code file extensions
-    std::set<std::string> code_extensions = {
-        ".py", ".js", ".ts", ".jsx", ".tsx", ".java", ".cpp", ".c", ".h", ".hpp",
-        ".go", ".rs", ".rb", ".php", ".swift", ".kt", ".cs", ".html",
-        ".css", ".scss", ".json", ".yaml", ".yml", ".md", ".sql", ".sh"
-    };
 
+    // Largest single file read out of an uploaded archive; bigger entries are skipped
+    size_t max_archive_entry_bytes;
+
+    // Concurrent scans of the same repository attach to the one already running
+    SingleFlight<std::string, json> scan_flight;
+
+    // Records scans as checkout accesses for LRU eviction (optional)
+    std::shared_ptr<RepositoryStore> repository_store;
+
+    // Embeds file summaries for retrieval after each scan (optional)
+    std::shared_ptr<EmbeddingService> embedding_service;
+    
     // Check if file should be skipped based on gitignore patterns
     bool shouldSkipFile(const std::string& file_path, const std::vector<std::string>& patterns) {
         for (const auto& pattern : patterns) {
@@ -154,66 +173,72 @@ private:
 
     // Detect the purpose of a file based on name and content
     std::string detectFilePurpose(const std::string& file_path, const json& analysis) {
-        std::string filename = fs::path(file_path).filename().string();
-        std::transform(filename.begin(), filename.end(), filename.begin(), ::tolower);
-        
-        // Check for test files
-        if (filename.find("test") != std::string::npos || 
-            filename.find("spec") != std::string::npos ||
-            filename.find(".test.") != std::string::npos ||
-            filename.find(".spec.") != std::string::npos) {
-            return "Test file - Contains unit tests and test cases";
-        }
-        
-        // Check for configuration files
-        if (filename == "config.py" || filename == "settings.py" || 
-            filename == "config.js" || filename == "config.ts" ||
-            filename == ".env" || filename.find("config") != std::string::npos) {
-            return "Configuration file - Stores application settings";
-        }
-        
-        // Check for package initializers
-        if (filename == "__init__.py") {
-            return "Package initializer - Makes directory a Python package";
-        }
-        
-        // Check for entry points
-        if (filename == "main.py" || filename == "app.py" || 
-            filename == "index.js" || filename == "server.js" ||
-            filename == "index.ts" || filename == "main.cpp") {
-            return "Entry point - Main application file";
-        }
-        
-        // Check for models/schemas
-        if (filename.find("model") != std::string::npos || 
-            filename.find("schema") != std::string::npos) {
-            return "Data model - Defines data structures and database schemas";
-        }
-        
-        // Check for services
-        if (filename.find("service") != std::string::npos) {
-            return "Service layer - Contains business logic";
+        return FileCategorizer::filePurpose(file_path);
+    }
+
+    // Store each file's component category so documentation requests never recompute it.
+    // Runs once paths are final (archive scans strip the top-level directory at the end).
+    void assignCategories(json& files) {
+        for (auto& [file_path, file_info] : files.items()) {
+            file_info["category"] = FileCategorizer::categorize(file_path, file_info.value("summary", ""));
         }
-        
-        // Check for controllers/routes
-        if (filename.find("controller") != std::string::npos || 
-            filename.find("route") != std::string::npos) {
-            return "Controller/Router - Handles HTTP requests and routing";
+    }
+
+    // Cluster near-duplicate files (same extension, estimated shingle Jaccard similarity at
+    // least MinHash::SIMILARITY_THRESHOLD) around one representative each: the richest file, then the first by path. Members
+    // get "duplicate_of"; representatives list their members under "near_duplicates".
+    // Recomputed over all files after every scan, since a rescan can split or join clusters.
+    void markNearDuplicates(json& files) {
+        struct Candidate {
+            std::string path;
+            MinHash::Signature signature;
+            size_t richness;
+        };
+        std::map<std::string, std::vector<Candidate>> by_extension;
+        for (auto& [file_path, file_info] : files.items()) {
+            file_info.erase("duplicate_of");
+            file_info.erase("near_duplicates");
+
+            MinHash::Signature signature;
+            if (!MinHash::fromHex(file_info.value("minhash", ""), signature)) continue;
+            size_t richness = 0;
+            if (file_info.contains("analysis")) {
+                const auto& analysis = file_info["analysis"];
+                richness = (analysis.contains("classes") ? analysis["classes"].size() * 2 : 0) +
+                           (analysis.contains("functions") ? analysis["functions"].size() : 0);
+            }
+            by_extension[file_info.value("extension", "")].push_back({file_path, signature, richness});
         }
-        
-        // Check for utilities
-        if (filename.find("util") != std::string::npos || 
-            filename.find("helper") != std::string::npos) {
-            return "Utility file - Helper functions and utilities";
+
+        size_t clustered = 0;
+        size_t clusters = 0;
+        for (auto& [_, candidates] : by_extension) {
+            std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+                if (a.richness != b.richness) return a.richness > b.richness;
+                return a.path < b.path;
+            });
+
+            NearDuplicateIndex index;
+            std::vector<std::string> representatives;
+            for (const auto& candidate : candidates) {
+                long representative = index.add(candidate.signature);
+                if (representative < 0) {
+                    representatives.push_back(candidate.path);
+                    continue;
+                }
+                const std::string& representative_path = representatives[representative];
+                files[candidate.path]["duplicate_of"] = representative_path;
+                json& members = files[representative_path]["near_duplicates"];
+                if (members.empty()) clusters++;
+                members.push_back(candidate.path);
+                clustered++;
+            }
         }
-        
-        // Check for types/interfaces (TypeScript)
-        if (filename.find("type") != std::string::npos || 
-            filename.find("interface") != std::string::npos) {
-            return "Type definitions - TypeScript types and interfaces";
+
+        if (clustered > 0) {
+            std::cout << "🧬 Collapsed " << clustered << " near-duplicate files into " << clusters
+                      << " representatives" << std::endl;
         }
-        
-        return "Source file - Contains application code";
     }
 
     // Generate a summary for a file
@@ -280,18 +305,71 @@ private:
         return result;
     }
 
-public:
-    ScannerService() {
-        const char* summaries = std::getenv("SUMMARIES_PATH");
-        summaries_path = summaries ? summaries : "./data/summaries";
-        fs::create_directories(summaries_path);
-        std::cout << "✓ Summaries storage path: " << summaries_path << std::endl;
+    // Analyze a single file's content and build its summary entry
+    json analyzeFile(const std::string& relative_path, const std::string& ext, const std::string& content) {
+        json analysis;
+        std::string analyzer = LanguageRegistry::getAnalyzer(ext);
+        if (analyzer == "python") {
+            analysis = analyzePythonFile(relative_path, content);
+        } else if (analyzer == "javascript") {
+            analysis = analyzeJavaScriptFile(content);
+        } else {
+            analysis["type"] = "other";
+            analysis["lines"] = std::count(content.begin(), content.end(), '\n') + 1;
+        }
+
+        json file_info;
+        file_info["path"] = relative_path;
+        file_info["extension"] = ext;
+        file_info["analysis"] = analysis;
+        file_info["summary"] = generateFileSummary(relative_path, analysis);
+
+        // Near-duplicate clustering needs only this signature, not the content
+        MinHash::Signature signature;
+        if (MinHash::signature(content, signature)) {
+            file_info["minhash"] = MinHash::toHex(signature);
+        }
+        return file_info;
+    }
+
+    // Read a file from disk and analyze it
+    json analyzeFileOnDisk(const std::string& file_path, const std::string& relative_path) {
+        std::ifstream file(file_path);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        std::string content = buffer.str();
+        file.close();
+
+        return analyzeFile(relative_path, fs::path(file_path).extension().string(), content);
+    }
+
+    // Persist scan results for a repository and refresh the cached copy.
+    // Written to a temp file of its own and renamed so readers never parse a half-written summary.
+    std::string saveSummary(const std::string& repo_id, const json& scan_results) {
+        std::string summary_file = summaries_path + "/" + repo_id + ".json";
+        std::string tmp_file = TempPath::uniqueFor(summary_file);
+
+        std::ofstream out(tmp_file);
+        out << scan_results.dump(2);
+        out.close();
+
+        // Keyed on the temp file's mtime, which the rename preserves
+        SummaryCache::instance().store(repo_id, tmp_file, scan_results);
+        fs::rename(tmp_file, summary_file);
+
+        return summary_file;
     }
 
-    // Scan an entire repository
-    json scanRepository(const std::string& repo_path) {
-        GitHubService github_service;
-        auto gitignore_patterns = github_service.getGitignorePatterns(repo_path);
+    // Queue a refresh of the repository's vector file. Embedding runs on the embedding
+    // service's worker, so scans neither wait for Ollama nor hold repository locks meanwhile.
+    void indexEmbeddings(const std::string& repo_id, const json& files) {
+        if (!embedding_service) return;
+        embedding_service->enqueueIndex(repo_id, files);
+    }
+
+    // Walk and analyze a repository checkout; callers hold the repository's shared lock
+    json performScan(const std::string& repo_path, const std::string& repo_id) {
+        auto gitignore_patterns = GitHubService::getGitignorePatterns(repo_path);
         
         json scan_results;
         json file_summaries;
@@ -306,47 +384,18 @@ public:
             std::string file_path = entry.path().string();
             std::string relative_path = fs::relative(file_path, repo_path).string();
             
-            // Skip files matching gitignore patterns
-            if (shouldSkipFile(file_path, gitignore_patterns)) continue;
+            // Skip files matching gitignore patterns (relative, so the mount point never matches)
+            if (shouldSkipFile(relative_path, gitignore_patterns)) continue;
             
             std::string ext = entry.path().extension().string();
             
             // Skip non-code files
-            if (code_extensions.find(ext) == code_extensions.end()) continue;
+            if (!isAnalyzable(ext)) continue;
             
             total_files++;
             
             try {
-                // Read file content
-                std::ifstream file(file_path);
-                std::stringstream buffer;
-                buffer << file.rdbuf();
-                std::string content = buffer.str();
-                file.close();
-                
-                // Analyze based on file type
-                json analysis;
-                if (ext == ".py") {
-                    analysis = analyzePythonFile(file_path, content);
-                } else if (ext == ".js" || ext == ".jsx" || ext == ".ts" || ext == ".tsx") {
-                    analysis = analyzeJavaScriptFile(content);
-                } else {
-                    analysis["type"] = "other";
-                    analysis["lines"] = std::count(content.begin(), content.end(), '\n') + 1;
-                }
-                
-                // Generate summary
-                std::string summary = generateFileSummary(file_path, analysis);
-                
-                // Store file information
-                json file_info;
-                file_info["path"] = relative_path;
-                file_info["extension"] = ext;
-                file_info["analysis"] = analysis;
-                file_info["summary"] = summary;
-                
-                file_summaries[relative_path] = file_info;
-                
+                file_summaries[relative_path] = analyzeFileOnDisk(file_path, relative_path);
                 std::cout << "✓ Analyzed: " << relative_path << std::endl;
                 
             } catch (const std::exception& e) {
@@ -354,38 +403,376 @@ public:
             }
         }
         
-        // Prepare final results
         scan_results["repo_path"] = repo_path;
+        return finishScan(repo_id, scan_results, total_files, file_summaries);
+    }
+
+    // Walk a commit's tree in a git object database and analyze blobs streamed from it;
+    // callers hold the repository's shared lock
+    json performCommitScan(const std::string& git_dir, const std::string& rev, const std::string& repo_id) {
+        GitObjectReader reader(git_dir);
+        std::string commit = reader.resolveCommit(rev);
+
+        std::string gitignore;
+        reader.readBlob(commit + ":.gitignore", gitignore);
+        auto gitignore_patterns = GitHubService::parseGitignorePatterns(gitignore);
+
+        json scan_results;
+        json file_summaries;
+        int total_files = 0;
+
+        std::cout << "\n🔍 Scanning commit " << commit.substr(0, 12) << " from " << git_dir << "\n" << std::endl;
+
+        std::string content;
+        for (const auto& entry : reader.listTree(commit)) {
+            if (shouldSkipFile(entry.path, gitignore_patterns)) continue;
+
+            std::string ext = fs::path(entry.path).extension().string();
+            if (!isAnalyzable(ext)) continue;
+
+            total_files++;
+
+            try {
+                if (!reader.readBlob(entry.oid, content)) {
+                    std::cerr << "✗ Missing blob for " << entry.path << std::endl;
+                    continue;
+                }
+                file_summaries[entry.path] = analyzeFile(entry.path, ext, content);
+                std::cout << "✓ Analyzed: " << entry.path << std::endl;
+
+            } catch (const std::exception& e) {
+                std::cerr << "✗ Error scanning " << entry.path << ": " << e.what() << std::endl;
+            }
+        }
+
+        scan_results["repo_path"] = git_dir;
+        scan_results["source"] = "git_objects";
+        scan_results["commit"] = commit;
+        return finishScan(repo_id, scan_results, total_files, file_summaries);
+    }
+
+    // Analyze an uploaded archive entry by entry, straight from the decompression stream;
+    // callers hold the repository's shared lock
+    json performArchiveScan(const std::string& archive_data, const std::string& name, const std::string& repo_id) {
+        auto gitignore_patterns = GitHubService::parseGitignorePatterns("");
+
+        json scan_results;
+        json file_summaries;
+        int total_files = 0;
+
+        // Archives usually wrap everything in one top-level directory ("project-main/...");
+        // filters see paths relative to it, and stored paths are too if every entry shares it
+        std::string root;
+        bool single_root = true;
+        bool first_entry = true;
+
+        auto relativePath = [&](const std::string& path) {
+            if (single_root && !root.empty() && path.compare(0, root.size(), root) == 0) {
+                return path.substr(root.size());
+            }
+            return path;
+        };
+
+        std::cout << "\n🔍 Scanning uploaded archive: " << name << "\n" << std::endl;
+
+        ArchiveReader reader(archive_data, max_archive_entry_bytes);
+        reader.forEachEntry(
+            [&](const std::string& path, long long) {
+                if (first_entry) {
+                    size_t slash = path.find('/');
+                    if (slash != std::string::npos) root = path.substr(0, slash + 1);
+                    else single_root = false;
+                    first_entry = false;
+                }
+                if (!root.empty() && path.compare(0, root.size(), root) != 0) single_root = false;
+
+                std::string relative_path = relativePath(path);
+                if (relative_path == ".gitignore") return true;
+                if (shouldSkipFile(relative_path, gitignore_patterns)) return false;
+                if (!isAnalyzable(fs::path(relative_path).extension().string())) return false;
+
+                total_files++;
+                return true;
+            },
+            [&](const std::string& path, const std::string& content) {
+                // Root .gitignore: apply it from here on and drop earlier entries it excludes
+                if (relativePath(path) == ".gitignore") {
+                    gitignore_patterns = GitHubService::parseGitignorePatterns(content);
+                    for (auto it = file_summaries.begin(); it != file_summaries.end();) {
+                        if (shouldSkipFile(relativePath(it.key()), gitignore_patterns)) {
+                            it = file_summaries.erase(it);
+                            total_files--;
+                        } else {
+                            ++it;
+                        }
+                    }
+                    return;
+                }
+
+                try {
+                    file_summaries[path] = analyzeFile(path, fs::path(path).extension().string(), content);
+                    std::cout << "✓ Analyzed: " << path << std::endl;
+                } catch (const std::exception& e) {
+                    std::cerr << "✗ Error scanning " << path << ": " << e.what() << std::endl;
+                }
+            });
+
+        // Every entry shared the top-level directory: report paths relative to it
+        if (!root.empty() && single_root) {
+            json relative_summaries;
+            for (auto& [path, file_info] : file_summaries.items()) {
+                std::string relative_path = relativePath(path);
+                file_info["path"] = relative_path;
+                relative_summaries[relative_path] = std::move(file_info);
+            }
+            file_summaries = std::move(relative_summaries);
+        }
+
+        const auto& stats = reader.getStats();
+        std::cout << "📦 Archive entries: " << stats.entries << ", inflated "
+                  << stats.bytes_inflated / 1024 << " KB, skipped (too large): "
+                  << stats.skipped_large << std::endl;
+
+        scan_results["repo_path"] = "upload://" + name;
+        scan_results["source"] = "archive";
+        scan_results["archive_format"] = ArchiveReader::detectFormat(archive_data);
+        scan_results["archive_entries"] = stats.entries;
+        scan_results["skipped_large_files"] = stats.skipped_large;
+        return finishScan(repo_id, scan_results, total_files, file_summaries);
+    }
+
+    // Attach totals and file entries to scan results and persist them
+    json finishScan(const std::string& repo_id, json scan_results, int total_files, json file_summaries) {
+        // Prepare final results
         scan_results["total_files"] = total_files;
         scan_results["analyzed_files"] = file_summaries.size();
-        scan_results["files"] = file_summaries;
-        
-        // Save to file
-        std::string repo_id = fs::path(repo_path).filename().string();
-        std::string summary_file = summaries_path + "/" + repo_id + ".json";
-        
-        std::ofstream out(summary_file);
-        out << scan_results.dump(2);
-        out.close();
+        scan_results["files"] = std::move(file_summaries);
+        assignCategories(scan_results["files"]);
+        markNearDuplicates(scan_results["files"]);
+        
+        // Prompt context depends only on scan data, so build it once here rather than per request
+        scan_results["context"] = ContextBuilder::buildContext(scan_results);
+        
+        // Save to file; a rescan in progress finishes its read-modify-save first
+        std::string summary_file;
+        {
+            std::lock_guard<std::mutex> writer(RepositoryLocks::summaryWriter(repo_id));
+            summary_file = saveSummary(repo_id, scan_results);
+        }
+        indexEmbeddings(repo_id, scan_results["files"]);
         
-        std::cout << "\n✅ Scan complete! Analyzed " << file_summaries.size() << " files" << std::endl;
+        std::cout << "\n✅ Scan complete! Analyzed " << scan_results["analyzed_files"].get<size_t>() << " files" << std::endl;
         std::cout << "📁 Results saved to: " << summary_file << "\n" << std::endl;
         
         return scan_results;
     }
 
-    // Get saved repository summary
-    json getRepositorySummary(const std::string& repo_id) {
+public:
+    ScannerService() {
+        const char* summaries = std::getenv("SUMMARIES_PATH");
+        summaries_path = summaries ? summaries : "./data/summaries";
+        fs::create_directories(summaries_path);
+        std::cout << "✓ Summaries storage path: " << summaries_path << std::endl;
+
+        const char* max_entry = std::getenv("UPLOAD_MAX_FILE_BYTES");
+        max_archive_entry_bytes = max_entry ? std::strtoull(max_entry, nullptr, 10) : 2 * 1024 * 1024;
+    }
+
+    // Check whether the scanner analyzes files with this extension
+    bool isAnalyzable(const std::string& ext) const {
+        return LanguageRegistry::isAnalyzable(ext);
+    }
+
+    // Scan an entire repository. Concurrent scans of the same repository share one pass.
+    json scanRepository(const std::string& repo_path, const std::string& repo_id_override = "") {
+        std::string repo_id = repo_id_override.empty()
+            ? fs::path(repo_path).filename().string()
+            : repo_id_override;
+
+        bool joined = false;
+        json scan_results = scan_flight.run(repo_id, [&]() {
+            std::shared_lock<std::shared_mutex> lock(RepositoryLocks::forRepo(repo_id));
+            return performScan(repo_path, repo_id);
+        }, &joined);
+
+        if (joined) {
+            std::cout << "🔗 Joined in-flight scan of " << repo_id << std::endl;
+        } else if (repository_store) {
+            repository_store->recordAccess(repo_id);
+        }
+
+        return scan_results;
+    }
+
+    // Attach the store that tracks checkout accesses
+    void setRepositoryStore(std::shared_ptr<RepositoryStore> store) {
+        repository_store = std::move(store);
+    }
+
+    // Attach the service that embeds scanned files for retrieval
+    void setEmbeddingService(std::shared_ptr<EmbeddingService> service) {
+        embedding_service = std::move(service);
+    }
+
+    // Scan a commit directly from a git object database (e.g. a bare mirror) without
+    // checking it out. Concurrent scans of the same repository share one pass.
+    json scanCommit(const std::string& git_dir, const std::string& rev, const std::string& repo_id) {
+        bool joined = false;
+        json scan_results = scan_flight.run(repo_id, [&]() {
+            std::shared_lock<std::shared_mutex> lock(RepositoryLocks::forRepo(repo_id));
+            return performCommitScan(git_dir, rev, repo_id);
+        }, &joined);
+
+        if (joined) {
+            std::cout << "🔗 Joined in-flight scan of " << repo_id << std::endl;
+        }
+
+        return scan_results;
+    }
+
+    // Scan an uploaded .tar.gz/.tar/.zip held in memory; nothing is extracted to disk.
+    // Only concurrent uploads of byte-identical archives share one pass: the repository id
+    // comes from the upload's name, so two different archives can arrive under the same one.
+    json scanArchive(const std::string& archive_data, const std::string& name, const std::string& repo_id) {
+        std::string flight_key = "upload:" + repo_id + ":" + ContentHash::sha256(archive_data);
+        bool joined = false;
+        json scan_results = scan_flight.run(flight_key, [&]() {
+            std::shared_lock<std::shared_mutex> lock(RepositoryLocks::forRepo(repo_id));
+            return performArchiveScan(archive_data, name, repo_id);
+        }, &joined);
+
+        if (joined) {
+            std::cout << "🔗 Joined in-flight scan of " << repo_id << std::endl;
+        }
+
+        return scan_results;
+    }
+
+    // Re-analyze only the given paths (relative to repo_path) and update the stored summary.
+    // Paths that no longer exist are dropped, along with everything beneath them.
+    json rescanFiles(
+        const std::string& repo_id,
+        const std::string& repo_path,
+        const std::vector<std::string>& changed_paths
+    ) {
+        std::shared_lock<std::shared_mutex> lock(RepositoryLocks::forRepo(repo_id));
+        // Other scans of this tree may run alongside, but only one may update its summary
+        std::lock_guard<std::mutex> writer(RepositoryLocks::summaryWriter(repo_id));
+
+        json scan_results = *getRepositorySummary(repo_id);
+        if (!scan_results.contains("files") || !scan_results["files"].is_object()) {
+            scan_results["files"] = json::object();
+        }
+        json& files = scan_results["files"];
+
+        auto gitignore_patterns = GitHubService::getGitignorePatterns(repo_path);
+
+        int total_files = scan_results.value("total_files", 0);
+        int updated = 0;
+        int removed = 0;
+
+        auto removeEntry = [&](const std::string& relative_path) {
+            if (files.erase(relative_path) > 0) {
+                total_files--;
+                removed++;
+            }
+        };
+
+        auto updateEntry = [&](const std::string& file_path, const std::string& relative_path) {
+            if (shouldSkipFile(relative_path, gitignore_patterns) ||
+                !isAnalyzable(fs::path(relative_path).extension().string())) {
+                removeEntry(relative_path);
+                return;
+            }
+
+            bool existed = files.contains(relative_path);
+            try {
+                files[relative_path] = analyzeFileOnDisk(file_path, relative_path);
+                if (!existed) total_files++;
+                updated++;
+            } catch (const std::exception& e) {
+                std::cerr << "✗ Error scanning " << relative_path << ": " << e.what() << std::endl;
+            }
+        };
+
+        for (const auto& relative_path : changed_paths) {
+            fs::path full_path = fs::path(repo_path) / relative_path;
+            std::error_code ec;
+
+            if (fs::is_regular_file(full_path, ec)) {
+                updateEntry(full_path.string(), relative_path);
+            } else if (fs::is_directory(full_path, ec)) {
+                // A directory appeared (e.g. moved in): analyze everything beneath it
+                for (const auto& entry : fs::recursive_directory_iterator(full_path, ec)) {
+                    if (!entry.is_regular_file()) continue;
+                    updateEntry(entry.path().string(), fs::relative(entry.path(), repo_path).string());
+                }
+            } else {
+                // Gone: drop the file itself or every entry under the removed directory
+                std::string prefix = relative_path + "/";
+                std::vector<std::string> stale;
+                for (auto& [path, _] : files.items()) {
+                    if (path == relative_path || path.rfind(prefix, 0) == 0) {
+                        stale.push_back(path);
+                    }
+                }
+                for (const auto& path : stale) {
+                    removeEntry(path);
+                }
+            }
+        }
+
+        scan_results["repo_path"] = repo_path;
+        scan_results["total_files"] = std::max(total_files, static_cast<int>(files.size()));
+        scan_results["analyzed_files"] = files.size();
+        assignCategories(files);
+        markNearDuplicates(files);
+        scan_results["context"] = ContextBuilder::buildContext(scan_results);
+        saveSummary(repo_id, scan_results);
+        indexEmbeddings(repo_id, files);
+
+        std::cout << "🔁 Incremental rescan of " << repo_id << ": " << updated
+                  << " updated, " << removed << " removed" << std::endl;
+
+        return scan_results;
+    }
+
+    // Parsed summary, shared with other readers through the summary cache
+    std::shared_ptr<const json> getRepositorySummary(const std::string& repo_id) {
         std::string summary_file = summaries_path + "/" + repo_id + ".json";
         
         if (!fs::exists(summary_file)) {
             throw std::runtime_error("Summary not found for repo: " + repo_id);
         }
         
-        std::ifstream file(summary_file);
-        json summary;
-        file >> summary;
-        return summary;
+        return SummaryCache::instance().load(repo_id, summary_file);
+    }
+
+    // Summary with each near-duplicate cluster reduced to its representative, which gets a
+    // near_duplicate_count; "near_duplicates_collapsed" counts the entries left out
+    static json collapseNearDuplicates(const json& summary) {
+        json collapsed = json::object();
+        size_t omitted = 0;
+        for (auto& [key, value] : summary.items()) {
+            if (key != "files") {
+                collapsed[key] = value;
+                continue;
+            }
+            json files = json::object();
+            for (auto& [file_path, file_info] : value.items()) {
+                if (ContextBuilder::isNearDuplicate(file_info)) {
+                    omitted++;
+                    continue;
+                }
+                files[file_path] = file_info;
+                if (file_info.contains("near_duplicates")) {
+                    files[file_path]["near_duplicate_count"] = file_info["near_duplicates"].size();
+                }
+            }
+            collapsed["files"] = std::move(files);
+        }
+        collapsed["near_duplicates_collapsed"] = omitted;
+        return collapsed;
     }
 
     // List all scanned repositories
@@ -0,0 +1,413 @@
+#ifndef WATCH_SERVICE_H
+#define WATCH_SERVICE_H
+
+#include <string>
+#include <map>
+#include <set>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <nlohmann/json.hpp>
+#include "GitHubService.h"
+#include "../utils/LanguageRegistry.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <climits>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+// Watches locally mounted repositories with inotify and reports debounced batches
+// of changed paths (relative to the repository root). The watcher thread blocks in
+// poll() with no timeout while nothing is pending, so idle repositories cost no CPU.
+// Only events for directories and analyzable files count. A batch is flushed after
+// WATCH_DEBOUNCE_MS without events, or WATCH_MAX_WAIT_MS after its first event if
+// events keep arriving.
+// If the kernel queue overflows, events were lost: the repository is re-watched and
+// its batch asks for a full rescan instead of listing paths.
+class WatchService {
+public:
+    using ChangeCallback = std::function<void(
+        const std::string& repo_id,
+        const std::string& root_path,
+        const std::vector<std::string>& changed_paths,
+        bool full_rescan)>;
+
+private:
+    struct WatchedRepo {
+        std::string root_path;
+        std::vector<std::string> ignore_patterns;
+        std::set<int> descriptors;
+        std::set<std::string> pending;
+        bool full_rescan = false;       // events were lost; changed paths are incomplete
+        std::chrono::steady_clock::time_point first_event;   // first event of the pending batch
+        std::chrono::steady_clock::time_point last_event;
+        long long batches_flushed = 0;
+    };
+
+    struct WatchTarget {
+        std::string repo_id;
+        std::string relative_dir;
+    };
+
+    ChangeCallback on_change;
+    std::chrono::milliseconds debounce;
+    std::chrono::milliseconds max_wait;
+    std::mutex mutex;
+    std::map<std::string, WatchedRepo> repos;
+    std::map<int, WatchTarget> targets;
+    std::atomic<bool> running{false};
+    std::thread worker;
+    int inotify_fd = -1;
+    int wake_fd = -1;
+
+    static bool isIgnored(const std::string& relative_path, const std::vector<std::string>& patterns) {
+        for (const auto& pattern : patterns) {
+            if (relative_path.find(pattern) != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+#ifdef __linux__
+    static constexpr uint32_t WATCH_MASK =
+        IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+        IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+
+    // Add a watch for one directory (caller holds the mutex)
+    void addWatch(const std::string& repo_id, WatchedRepo& repo, const std::string& relative_dir) {
+        std::string full_path = relative_dir.empty()
+            ? repo.root_path
+            : (fs::path(repo.root_path) / relative_dir).string();
+
+        int wd = inotify_add_watch(inotify_fd, full_path.c_str(), WATCH_MASK);
+        if (wd < 0) {
+            std::cerr << "⚠ Failed to watch " << full_path << ": " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        repo.descriptors.insert(wd);
+        targets[wd] = {repo_id, relative_dir};
+    }
+
+    // Add watches for a directory and every non-ignored directory beneath it (caller holds the mutex)
+    void addWatchesRecursive(const std::string& repo_id, WatchedRepo& repo, const std::string& relative_dir) {
+        addWatch(repo_id, repo, relative_dir);
+
+        fs::path start = relative_dir.empty() ? fs::path(repo.root_path) : fs::path(repo.root_path) / relative_dir;
+        std::error_code ec;
+        fs::recursive_directory_iterator it(start, fs::directory_options::skip_permission_denied, ec);
+        for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (!it->is_directory(ec) || it->is_symlink(ec)) continue;
+
+            std::string relative = fs::relative(it->path(), repo.root_path).string();
+            if (isIgnored(relative, repo.ignore_patterns)) {
+                it.disable_recursion_pending();
+                continue;
+            }
+            addWatch(repo_id, repo, relative);
+        }
+    }
+
+    // Drop watches for a directory that left the tree, and for its subdirectories (caller holds the mutex)
+    void removeWatchesUnder(WatchedRepo& repo, const std::string& relative_dir) {
+        std::string prefix = relative_dir + "/";
+        for (auto it = repo.descriptors.begin(); it != repo.descriptors.end();) {
+            const auto& dir = targets[*it].relative_dir;
+            if (dir == relative_dir || dir.rfind(prefix, 0) == 0) {
+                inotify_rm_watch(inotify_fd, *it);
+                targets.erase(*it);
+                it = repo.descriptors.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Drop watches on directories that no longer exist and watch any that appeared;
+    // re-adding an existing watch returns its descriptor unchanged (caller holds the mutex)
+    void rewatch(const std::string& repo_id, WatchedRepo& repo) {
+        for (auto it = repo.descriptors.begin(); it != repo.descriptors.end();) {
+            const auto& dir = targets[*it].relative_dir;
+            std::error_code ec;
+            fs::path full_path = dir.empty() ? fs::path(repo.root_path) : fs::path(repo.root_path) / dir;
+            if (fs::is_directory(full_path, ec)) {
+                ++it;
+                continue;
+            }
+            inotify_rm_watch(inotify_fd, *it);
+            targets.erase(*it);
+            it = repo.descriptors.erase(it);
+        }
+        addWatchesRecursive(repo_id, repo, "");
+    }
+
+    void handleEvent(const inotify_event* event) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto now = std::chrono::steady_clock::now();
+
+        if (event->mask & IN_Q_OVERFLOW) {
+            // Events were lost, including deletions and new directories: rebuild the
+            // watches and rescan every watched repository in full
+            std::cerr << "⚠ inotify queue overflowed, rescanning watched repositories" << std::endl;
+            for (auto& [repo_id, repo] : repos) {
+                rewatch(repo_id, repo);
+                markPending(repo, now);
+                repo.full_rescan = true;
+                repo.pending.clear();
+            }
+            return;
+        }
+
+        auto target_it = targets.find(event->wd);
+        if (target_it == targets.end()) return;
+
+        if (event->mask & IN_IGNORED) {
+            auto repo_it = repos.find(target_it->second.repo_id);
+            if (repo_it != repos.end()) repo_it->second.descriptors.erase(event->wd);
+            targets.erase(target_it);
+            return;
+        }
+
+        if (event->len == 0) return;
+
+        auto repo_it = repos.find(target_it->second.repo_id);
+        if (repo_it == repos.end()) return;
+        WatchedRepo& repo = repo_it->second;
+
+        std::string name = event->name;
+        std::string relative = target_it->second.relative_dir.empty()
+            ? name
+            : target_it->second.relative_dir + "/" + name;
+
+        if (isIgnored(relative, repo.ignore_patterns)) return;
+
+        if (event->mask & IN_ISDIR) {
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                addWatchesRecursive(repo_it->first, repo, relative);
+            } else if (event->mask & IN_MOVED_FROM) {
+                removeWatchesUnder(repo, relative);
+            }
+        } else if (event->mask & IN_CREATE) {
+            // Wait for IN_CLOSE_WRITE before analyzing a newly created file
+            return;
+        } else if (!LanguageRegistry::isAnalyzable(fs::path(relative).extension().string())) {
+            // Logs, build outputs and swap files would never be rescanned, and must not
+            // hold back the batch
+            return;
+        }
+
+        markPending(repo, now);
+        if (!repo.full_rescan) repo.pending.insert(relative);
+    }
+
+    // Record an event time, starting the max-wait clock if nothing was pending (caller holds the mutex)
+    static void markPending(WatchedRepo& repo, std::chrono::steady_clock::time_point now) {
+        if (repo.pending.empty() && !repo.full_rescan) repo.first_event = now;
+        repo.last_event = now;
+    }
+
+    struct Batch {
+        std::string repo_id;
+        std::string root_path;
+        std::vector<std::string> changed_paths;
+        bool full_rescan;
+    };
+
+    // Collect batches whose quiet period or max wait has elapsed; returns the poll timeout for the next wait
+    int collectReady(std::vector<Batch>& ready) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto now = std::chrono::steady_clock::now();
+        int timeout_ms = -1;
+
+        for (auto& [repo_id, repo] : repos) {
+            if (repo.pending.empty() && !repo.full_rescan) continue;
+
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - repo.last_event);
+            auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(now - repo.first_event);
+            if (elapsed >= debounce || waited >= max_wait) {
+                ready.push_back({repo_id, repo.root_path,
+                    std::vector<std::string>(repo.pending.begin(), repo.pending.end()), repo.full_rescan});
+                repo.pending.clear();
+                repo.full_rescan = false;
+                repo.batches_flushed++;
+            } else {
+                int remaining = static_cast<int>(std::min(debounce - elapsed, max_wait - waited).count());
+                timeout_ms = timeout_ms < 0 ? remaining : std::min(timeout_ms, remaining);
+            }
+        }
+
+        return timeout_ms;
+    }
+
+    void run() {
+        alignas(inotify_event) char buffer[64 * (sizeof(inotify_event) + NAME_MAX + 1)];
+
+        while (running) {
+            std::vector<Batch> ready;
+            int timeout_ms = collectReady(ready);
+
+            for (const auto& batch : ready) {
+                try {
+                    on_change(batch.repo_id, batch.root_path, batch.changed_paths, batch.full_rescan);
+                } catch (const std::exception& e) {
+                    std::cerr << "❌ Incremental rescan failed for " << batch.repo_id << ": " << e.what() << std::endl;
+                }
+            }
+            if (!ready.empty()) continue;
+
+            pollfd fds[2] = {{inotify_fd, POLLIN, 0}, {wake_fd, POLLIN, 0}};
+            int rc = poll(fds, 2, timeout_ms);
+            if (rc < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "❌ Watch poll failed: " << std::strerror(errno) << std::endl;
+                break;
+            }
+
+            if (fds[1].revents & POLLIN) {
+                uint64_t value;
+                ssize_t ignored = read(wake_fd, &value, sizeof(value));
+                (void)ignored;
+            }
+
+            if (fds[0].revents & POLLIN) {
+                ssize_t length;
+                while ((length = read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+                    for (char* ptr = buffer; ptr < buffer + length;) {
+                        auto* event = reinterpret_cast<const inotify_event*>(ptr);
+                        handleEvent(event);
+                        ptr += sizeof(inotify_event) + event->len;
+                    }
+                }
+            }
+        }
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+#endif
+
+public:
+    explicit WatchService(ChangeCallback callback) : on_change(std::move(callback)) {
+        const char* debounce_env = std::getenv("WATCH_DEBOUNCE_MS");
+        debounce = std::chrono::milliseconds(debounce_env ? std::atoi(debounce_env) : 500);
+        const char* max_wait_env = std::getenv("WATCH_MAX_WAIT_MS");
+        max_wait = std::chrono::milliseconds(max_wait_env ? std::atoi(max_wait_env) : 10000);
+
+#ifdef __linux__
+        inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (inotify_fd < 0 || wake_fd < 0) {
+            std::cerr << "⚠ inotify unavailable, watch mode disabled: " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        running = true;
+        worker = std::thread(&WatchService::run, this);
+        std::cout << "✓ Watch service started (debounce: " << debounce.count()
+                  << " ms, max wait: " << max_wait.count() << " ms)" << std::endl;
+#else
+        std::cout << "⚠ Watch mode is only supported on Linux (inotify)" << std::endl;
+#endif
+    }
+
+    ~WatchService() {
+#ifdef __linux__
+        if (running) {
+            running = false;
+            wake();
+            worker.join();
+        }
+        if (inotify_fd >= 0) close(inotify_fd);
+        if (wake_fd >= 0) close(wake_fd);
+#endif
+    }
+
+    WatchService(const WatchService&) = delete;
+    WatchService& operator=(const WatchService&) = delete;
+
+    // Start watching a local repository root
+    void watch(const std::string& repo_id, const std::string& root_path) {
+#ifdef __linux__
+        if (!running) {
+            throw std::runtime_error("Watch service is not running (inotify unavailable)");
+        }
+
+        auto patterns = GitHubService::getGitignorePatterns(root_path);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (repos.count(repo_id)) {
+            std::cout << "👀 Already watching: " << root_path << std::endl;
+            return;
+        }
+
+        WatchedRepo& repo = repos[repo_id];
+        repo.root_path = root_path;
+        repo.ignore_patterns = std::move(patterns);
+        addWatchesRecursive(repo_id, repo, "");
+
+        std::cout << "👀 Watching " << root_path << " (" << repo.descriptors.size()
+                  << " directories)" << std::endl;
+#else
+        throw std::runtime_error("Watch mode requires inotify (Linux only)");
+#endif
+    }
+
+    // Stop watching a repository; returns false if it was not watched
+    bool unwatch(const std::string& repo_id) {
+#ifdef __linux__
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = repos.find(repo_id);
+        if (it == repos.end()) return false;
+
+        for (int wd : it->second.descriptors) {
+            inotify_rm_watch(inotify_fd, wd);
+            targets.erase(wd);
+        }
+        repos.erase(it);
+
+        std::cout << "🛑 Stopped watching: " << repo_id << std::endl;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Describe every watched repository
+    json listWatches() {
+        std::lock_guard<std::mutex> lock(mutex);
+        json watches = json::array();
+
+        for (const auto& [repo_id, repo] : repos) {
+            json entry;
+            entry["repo_id"] = repo_id;
+            entry["local_path"] = repo.root_path;
+            entry["watched_directories"] = repo.descriptors.size();
+            entry["pending_changes"] = repo.pending.size();
+            entry["full_rescan_pending"] = repo.full_rescan;
+            entry["batches_flushed"] = repo.batches_flushed;
+            watches.push_back(entry);
+        }
+
+        return watches;
+    }
+};
+
+#endif // WATCH_SERVICE_H
@@ -0,0 +1,379 @@
+#ifndef ARCHIVE_READER_H
+#define ARCHIVE_READER_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <zlib.h>
+
+// Walks the entries of an in-memory .tar, .tar.gz or .zip archive without
+// extracting anything to disk. Data is inflated in fixed-size chunks and only
+// entries the caller asks for (and that fit max_entry_bytes) are buffered, so
+// memory stays bounded by the largest accepted file rather than the archive.
+class ArchiveReader {
+public:
+    // Return true to receive the entry's content
+    using EntryFilter = std::function<bool(const std::string& path, long long size)>;
+    using EntryCallback = std::function<void(const std::string& path, const std::string& content)>;
+
+    struct Stats {
+        long long entries = 0;
+        long long skipped_large = 0;
+        long long bytes_inflated = 0;
+    };
+
+private:
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+    // Largest GNU long-name or pax header kept; bigger ones are skipped unread
+    static constexpr long long MAX_METADATA_BYTES = 64 * 1024;
+
+    const std::string& data;
+    size_t max_entry_bytes;
+    Stats stats;
+
+    static uint16_t readLE16(const unsigned char* p) {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    static uint32_t readLE32(const unsigned char* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    static long long parseOctal(const char* field, size_t length) {
+        long long value = 0;
+        for (size_t i = 0; i < length && field[i]; ++i) {
+            if (field[i] == ' ') continue;
+            if (field[i] < '0' || field[i] > '7') break;
+            value = value * 8 + (field[i] - '0');
+        }
+        return value;
+    }
+
+    static std::string fieldString(const char* field, size_t length) {
+        return std::string(field, strnlen(field, length));
+    }
+
+    // Incremental tar parser fed with decompressed bytes in arbitrary chunk sizes
+    class TarStream {
+    private:
+        ArchiveReader& reader;
+        const EntryFilter& wants;
+        const EntryCallback& on_entry;
+
+        char header[512];
+        size_t header_fill = 0;
+        long long remaining = 0;      // content bytes left in the current entry
+        long long padding = 0;        // zero padding after the content
+        bool capture = false;         // buffering current entry for the callback
+        bool is_metadata = false;     // GNU long name or pax header being read
+        char metadata_type = 0;
+        std::string metadata;
+        std::string long_name;        // path override for the next entry
+        std::string path;
+        std::string content;
+        bool finished = false;
+
+        // Extract "path" from a pax extended header ("<len> path=<value>\n" records)
+        static std::string paxPath(const std::string& records) {
+            size_t pos = 0;
+            while (pos < records.size()) {
+                size_t space = records.find(' ', pos);
+                if (space == std::string::npos) break;
+                size_t length = std::strtoul(records.c_str() + pos, nullptr, 10);
+                if (length == 0 || pos + length > records.size()) break;
+
+                std::string record = records.substr(space + 1, pos + length - space - 2);
+                if (record.compare(0, 5, "path=") == 0) return record.substr(5);
+                pos += length;
+            }
+            return "";
+        }
+
+        void startEntry() {
+            bool empty_block = true;
+            for (char c : header) {
+                if (c != 0) { empty_block = false; break; }
+            }
+            if (empty_block) {
+                finished = true;   // end-of-archive marker
+                return;
+            }
+
+            long long size = parseOctal(header + 124, 12);
+            char type = header[156];
+            remaining = size;
+            padding = (512 - size % 512) % 512;
+
+            if (type == 'L' || type == 'x') {
+                // An oversized header is consumed and dropped like an unwanted entry, so
+                // the next entry keeps its own name instead of buffering unbounded metadata
+                is_metadata = size <= MAX_METADATA_BYTES;
+                capture = false;
+                metadata_type = type;
+                metadata.clear();
+                if (is_metadata) metadata.reserve(static_cast<size_t>(size));
+                if (remaining == 0) finishEntry();
+                return;
+            }
+            is_metadata = false;
+
+            path = fieldString(header, 100);
+            std::string prefix = fieldString(header + 345, 155);
+            if (std::memcmp(header + 257, "ustar", 5) == 0 && !prefix.empty()) {
+                path = prefix + "/" + path;
+            }
+            if (!long_name.empty()) {
+                path = long_name;
+                long_name.clear();
+            }
+
+            // Only regular files carry content worth analyzing
+            bool regular = type == '0' || type == '\0' || type == '7';
+            capture = false;
+            if (regular) {
+                reader.stats.entries++;
+                if (wants(path, size)) {
+                    if (static_cast<size_t>(size) > reader.max_entry_bytes) {
+                        reader.stats.skipped_large++;
+                    } else {
+                        capture = true;
+                        content.clear();
+                        content.reserve(static_cast<size_t>(size));
+                    }
+                }
+            }
+            if (remaining == 0) finishEntry();
+        }
+
+        void finishEntry() {
+            if (is_metadata) {
+                if (metadata_type == 'L') {
+                    long_name = std::string(metadata.c_str());
+                } else {
+                    std::string pax = paxPath(metadata);
+                    if (!pax.empty()) long_name = pax;
+                }
+                is_metadata = false;
+            } else if (capture) {
+                on_entry(path, content);
+                capture = false;
+            }
+        }
+
+    public:
+        TarStream(ArchiveReader& owner, const EntryFilter& filter, const EntryCallback& callback)
+            : reader(owner), wants(filter), on_entry(callback) {}
+
+        bool isFinished() const { return finished; }
+
+        void feed(const char* bytes, size_t length) {
+            while (length > 0 && !finished) {
+                if (remaining > 0) {
+                    size_t take = static_cast<size_t>(std::min<long long>(remaining, static_cast<long long>(length)));
+                    if (is_metadata) metadata.append(bytes, take);
+                    else if (capture) content.append(bytes, take);
+                    bytes += take;
+                    length -= take;
+                    remaining -= take;
+                    if (remaining == 0) finishEntry();
+                } else if (padding > 0) {
+                    size_t take = static_cast<size_t>(std::min<long long>(padding, static_cast<long long>(length)));
+                    bytes += take;
+                    length -= take;
+                    padding -= take;
+                } else {
+                    size_t take = std::min(sizeof(header) - header_fill, length);
+                    std::memcpy(header + header_fill, bytes, take);
+                    header_fill += take;
+                    bytes += take;
+                    length -= take;
+                    if (header_fill == sizeof(header)) {
+                        header_fill = 0;
+                        startEntry();
+                    }
+                }
+            }
+        }
+    };
+
+    void readTar(const EntryFilter& wants, const EntryCallback& on_entry) {
+        TarStream tar(*this, wants, on_entry);
+        for (size_t offset = 0; offset < data.size() && !tar.isFinished(); offset += CHUNK_SIZE) {
+            tar.feed(data.data() + offset, std::min(CHUNK_SIZE, data.size() - offset));
+        }
+    }
+
+    void readTarGz(const EntryFilter& wants, const EntryCallback& on_entry) {
+        z_stream stream{};
+        if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+            throw std::runtime_error("Failed to initialize gzip decompression");
+        }
+
+        TarStream tar(*this, wants, on_entry);
+        std::vector<char> out(CHUNK_SIZE);
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream.avail_in = static_cast<uInt>(data.size());
+
+        int status = Z_OK;
+        try {
+            while (status != Z_STREAM_END && !tar.isFinished()) {
+                stream.next_out = reinterpret_cast<Bytef*>(out.data());
+                stream.avail_out = static_cast<uInt>(out.size());
+                status = inflate(&stream, Z_NO_FLUSH);
+                if (status != Z_OK && status != Z_STREAM_END) {
+                    throw std::runtime_error("Corrupt gzip stream" +
+                                             std::string(stream.msg ? std::string(": ") + stream.msg : ""));
+                }
+
+                size_t produced = out.size() - stream.avail_out;
+                stats.bytes_inflated += produced;
+                tar.feed(out.data(), produced);
+
+                if (produced == 0 && stream.avail_in == 0 && status != Z_STREAM_END) {
+                    throw std::runtime_error("Truncated gzip stream");
+                }
+            }
+        } catch (...) {
+            inflateEnd(&stream);
+            throw;
+        }
+        inflateEnd(&stream);
+    }
+
+    // Inflate a raw deflate zip entry; output beyond max_entry_bytes is never kept
+    std::string inflateZipEntry(const unsigned char* compressed, size_t compressed_size, size_t expected_size) {
+        z_stream stream{};
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+            throw std::runtime_error("Failed to initialize zip decompression");
+        }
+
+        std::string content;
+        content.reserve(expected_size);
+        std::vector<char> out(CHUNK_SIZE);
+        stream.next_in = const_cast<Bytef*>(compressed);
+        stream.avail_in = static_cast<uInt>(compressed_size);
+
+        int status = Z_OK;
+        while (status != Z_STREAM_END) {
+            stream.next_out = reinterpret_cast<Bytef*>(out.data());
+            stream.avail_out = static_cast<uInt>(out.size());
+            status = inflate(&stream, Z_NO_FLUSH);
+            size_t produced = out.size() - stream.avail_out;
+            if ((status != Z_OK && status != Z_STREAM_END) ||
+                (produced == 0 && stream.avail_in == 0 && status != Z_STREAM_END) ||
+                content.size() + produced > max_entry_bytes) {
+                inflateEnd(&stream);
+                throw std::runtime_error("Corrupt or oversized zip entry");
+            }
+            stats.bytes_inflated += produced;
+            content.append(out.data(), produced);
+        }
+
+        inflateEnd(&stream);
+        return content;
+    }
+
+    // Zip entries are located through the central directory, which carries reliable
+    // sizes even when the local headers defer them to a trailing data descriptor
+    void readZip(const EntryFilter& wants, const EntryCallback& on_entry) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+        size_t size = data.size();
+
+        // End of central directory record: 22 bytes plus an optional comment of up to 64 KB
+        size_t eocd = std::string::npos;
+        size_t search_floor = size > 22 + 65535 ? size - 22 - 65535 : 0;
+        for (size_t pos = size >= 22 ? size - 22 : 0; size >= 22; --pos) {
+            if (readLE32(bytes + pos) == 0x06054b50) { eocd = pos; break; }
+            if (pos == search_floor) break;
+        }
+        if (eocd == std::string::npos) {
+            throw std::runtime_error("Invalid zip archive: end of central directory not found");
+        }
+
+        uint16_t entry_count = readLE16(bytes + eocd + 10);
+        size_t offset = readLE32(bytes + eocd + 16);
+
+        for (uint16_t i = 0; i < entry_count; ++i) {
+            if (offset + 46 > size || readLE32(bytes + offset) != 0x02014b50) {
+                throw std::runtime_error("Invalid zip archive: corrupt central directory");
+            }
+
+            uint16_t method = readLE16(bytes + offset + 10);
+            uint32_t compressed_size = readLE32(bytes + offset + 20);
+            uint32_t uncompressed_size = readLE32(bytes + offset + 24);
+            uint16_t name_length = readLE16(bytes + offset + 28);
+            uint16_t extra_length = readLE16(bytes + offset + 30);
+            uint16_t comment_length = readLE16(bytes + offset + 32);
+            uint32_t local_offset = readLE32(bytes + offset + 42);
+            if (offset + 46 + name_length > size) {
+                throw std::runtime_error("Invalid zip archive: corrupt central directory");
+            }
+            std::string path(reinterpret_cast<const char*>(bytes + offset + 46), name_length);
+            offset += 46 + name_length + extra_length + comment_length;
+
+            if (path.empty() || path.back() == '/') continue;   // directory entry
+            stats.entries++;
+            if (!wants(path, uncompressed_size)) continue;
+            if (uncompressed_size > max_entry_bytes) {
+                stats.skipped_large++;
+                continue;
+            }
+
+            if (static_cast<size_t>(local_offset) + 30 > size || readLE32(bytes + local_offset) != 0x04034b50) {
+                throw std::runtime_error("Invalid zip archive: bad local header for " + path);
+            }
+            size_t data_start = local_offset + 30 + readLE16(bytes + local_offset + 26) +
+                                readLE16(bytes + local_offset + 28);
+            if (data_start + compressed_size > size) {
+                throw std::runtime_error("Invalid zip archive: truncated entry " + path);
+            }
+
+            if (method == 0) {
+                stats.bytes_inflated += compressed_size;
+                on_entry(path, std::string(reinterpret_cast<const char*>(bytes + data_start), compressed_size));
+            } else if (method == 8) {
+                on_entry(path, inflateZipEntry(bytes + data_start, compressed_size, uncompressed_size));
+            } else {
+                throw std::runtime_error("Unsupported zip compression method " + std::to_string(method) +
+                                         " for " + path);
+            }
+        }
+    }
+
+public:
+    ArchiveReader(const std::string& archive_data, size_t max_entry_size)
+        : data(archive_data), max_entry_bytes(max_entry_size) {}
+
+    // "tar.gz", "zip" or "tar" from the archive's magic bytes, or "" if unrecognized
+    static std::string detectFormat(const std::string& archive_data) {
+        if (archive_data.size() >= 2 &&
+            static_cast<unsigned char>(archive_data[0]) == 0x1f &&
+            static_cast<unsigned char>(archive_data[1]) == 0x8b) {
+            return "tar.gz";
+        }
+        if (archive_data.size() >= 4 && archive_data.compare(0, 4, "PK\x03\x04") == 0) {
+            return "zip";
+        }
+        if (archive_data.size() >= 262 && archive_data.compare(257, 5, "ustar") == 0) {
+            return "tar";
+        }
+        return "";
+    }
+
+    // Visit every regular file; content is delivered only for entries the filter accepts
+    void forEachEntry(const EntryFilter& wants, const EntryCallback& on_entry) {
+        std::string format = detectFormat(data);
+        if (format == "tar.gz") readTarGz(wants, on_entry);
+        else if (format == "zip") readZip(wants, on_entry);
+        else if (format == "tar") readTar(wants, on_entry);
+        else throw std::runtime_error("Unsupported archive format (expected .tar.gz, .tar or .zip)");
+    }
+
+    const Stats& getStats() const { return stats; }
+};
+
+#endif // ARCHIVE_READER_H
@@ -0,0 +1,118 @@
+#ifndef CIRCUIT_BREAKER_H
+#define CIRCUIT_BREAKER_H
+
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+// Failure gate for a remote dependency. Closed lets calls through; after
+// failure_threshold consecutive failures it opens and rejects calls without
+// trying. Once open_duration has passed, a single trial call (half-open) decides
+// whether it closes again or re-opens for another open_duration. allow() is a
+// single atomic load, so callers can consult it on every request.
+class CircuitBreaker {
+public:
+    enum class State { Closed, Open, HalfOpen };
+
+    struct Snapshot {
+        State state;
+        size_t consecutive_failures;
+        size_t times_opened;
+        std::string last_error;
+        std::chrono::steady_clock::time_point changed_at;
+        std::chrono::steady_clock::time_point retry_at;   // when an open breaker may be tried again
+    };
+
+    CircuitBreaker(size_t failure_threshold, std::chrono::milliseconds open_duration)
+        : failure_threshold(std::max<size_t>(1, failure_threshold)), open_duration(open_duration) {
+        changed_at = retry_at = std::chrono::steady_clock::now();
+    }
+
+    // Whether calls should be attempted right now
+    bool allow() const {
+        return state.load(std::memory_order_acquire) == State::Closed;
+    }
+
+    State current() const {
+        return state.load(std::memory_order_acquire);
+    }
+
+    void recordSuccess() {
+        std::lock_guard<std::mutex> lock(mutex);
+        consecutive_failures = 0;
+        last_error.clear();
+        if (state.load(std::memory_order_relaxed) != State::Closed) transition(State::Closed);
+    }
+
+    void recordFailure(const std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        consecutive_failures++;
+        last_error = error;
+        State current_state = state.load(std::memory_order_relaxed);
+        if (current_state == State::HalfOpen ||
+            (current_state == State::Closed && consecutive_failures >= failure_threshold)) {
+            open();
+        }
+    }
+
+    // Open immediately regardless of the failure count (e.g. the dependency is known to be down)
+    void trip() {
+        std::lock_guard<std::mutex> lock(mutex);
+        open();
+    }
+
+    // Move an open breaker whose open_duration has passed to half-open. Returns true
+    // if the caller now owns the trial call and must report its outcome.
+    bool tryHalfOpen() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (state.load(std::memory_order_relaxed) != State::Open) return false;
+        if (std::chrono::steady_clock::now() < retry_at) return false;
+        transition(State::HalfOpen);
+        return true;
+    }
+
+    Snapshot snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return {state.load(std::memory_order_relaxed), consecutive_failures, times_opened,
+                last_error, changed_at, retry_at};
+    }
+
+    static const char* stateName(State state) {
+        switch (state) {
+            case State::Closed: return "closed";
+            case State::Open: return "open";
+            case State::HalfOpen: return "half_open";
+        }
+        return "unknown";
+    }
+
+private:
+    const size_t failure_threshold;
+    const std::chrono::milliseconds open_duration;
+
+    std::atomic<State> state{State::Closed};
+    mutable std::mutex mutex;
+    size_t consecutive_failures = 0;
+    size_t times_opened = 0;
+    std::string last_error;
+    std::chrono::steady_clock::time_point changed_at;
+    std::chrono::steady_clock::time_point retry_at;
+
+    // Caller holds the mutex
+    void open() {
+        retry_at = std::chrono::steady_clock::now() + open_duration;
+        if (state.load(std::memory_order_relaxed) != State::Open) {
+            times_opened++;
+            transition(State::Open);
+        }
+    }
+
+    void transition(State next) {
+        state.store(next, std::memory_order_release);
+        changed_at = std::chrono::steady_clock::now();
+    }
+};
+
+#endif // CIRCUIT_BREAKER_H
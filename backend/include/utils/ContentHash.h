@@ -0,0 +1,28 @@
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <openssl/evp.h>
+
+// Stable content fingerprints for cache keys
+class ContentHash {
+public:
+    static std::string sha256(const std::string& data) {
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int length = 0;
+        if (EVP_Digest(data.data(), data.size(), digest, &length, EVP_sha256(), nullptr) != 1) {
+            throw std::runtime_error("Failed to compute SHA-256 digest");
+        }
+
+        std::ostringstream hex;
+        for (unsigned int i = 0; i < length; ++i) {
+            hex << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest[i]);
+        }
+        return hex.str();
+    }
+};
+
+#endif // CONTENT_HASH_H
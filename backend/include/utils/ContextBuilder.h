@@ -0,0 +1,285 @@
+#ifndef CONTEXT_BUILDER_H
+#define CONTEXT_BUILDER_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+#include "ContentHash.h"
+#include "FileCategorizer.h"
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+// Builds the repository context that documentation prompts are assembled from
+// (overview, file structure, categorized key files). It depends only on scan
+// data, so the scanner computes it once per scan and stores it in the summary
+// under "context"; DocumentationService falls back to building it on demand
+// for summaries written before this existed.
+class ContextBuilder {
+public:
+    // Bump when the rendered context changes so stale summaries are rebuilt on read
+    static constexpr int VERSION = 3;
+
+    // Build repository overview string
+    static std::string buildRepositoryOverview(const json& repo_data) {
+        std::ostringstream overview;
+
+        int total_files = repo_data.value("analyzed_files", 0);
+        int total_lines = 0;
+        std::map<std::string, int> languages;
+
+        if (repo_data.contains("files")) {
+            for (auto& [file_path, file_info] : repo_data["files"].items()) {
+                if (file_info.contains("analysis")) {
+                    total_lines += file_info["analysis"].value("lines", 0);
+                    std::string type = file_info["analysis"].value("type", "unknown");
+                    languages[type]++;
+                }
+            }
+        }
+
+        overview << "- Total Files: " << total_files << "\n";
+        overview << "- Total Lines of Code: " << total_lines << "\n";
+        overview << "- Languages/Technologies: ";
+
+        for (const auto& [lang, count] : languages) {
+            overview << lang << " (" << count << " files), ";
+        }
+
+        return overview.str();
+    }
+
+    // Build file structure summary
+    static std::string buildFileStructure(const json& repo_data) {
+        std::ostringstream structure;
+
+        if (!repo_data.contains("files")) {
+            return "No file information available.\n";
+        }
+
+        // Organize files by directory
+        std::map<std::string, std::vector<std::string>> dirs;
+
+        // Near-duplicates are listed once, on their representative
+        for (auto& [file_path, file_info] : repo_data["files"].items()) {
+            if (isNearDuplicate(file_info)) continue;
+            fs::path p(file_path);
+            std::string dir = p.parent_path().string();
+            if (dir.empty()) dir = ".";
+            std::string name = p.filename().string();
+            if (file_info.contains("near_duplicates")) {
+                name += " (+" + std::to_string(file_info["near_duplicates"].size()) + " near-duplicates)";
+            }
+            dirs[dir].push_back(name);
+        }
+
+        // Output structure
+        for (const auto& [dir, files] : dirs) {
+            structure << "**" << dir << "/**\n";
+            for (const auto& file : files) {
+                structure << "  - " << file << "\n";
+            }
+            structure << "\n";
+        }
+
+        return structure.str();
+    }
+
+    // Whether the scanner folded this file into a near-duplicate cluster's representative
+    static bool isNearDuplicate(const json& file_info) {
+        return file_info.contains("duplicate_of");
+    }
+
+    // Component category for a file, from its summary, name and directory
+    static std::string categorizeFile(const std::string& file_path, const json& file_info) {
+        return FileCategorizer::categorize(file_path, file_info.value("summary", ""));
+    }
+
+    // Render one key file entry (summary, type, functions, classes, dependencies)
+    static std::string renderKeyFile(const std::string& file_path, const json& file_info) {
+        std::ostringstream summary;
+        summary << "**" << file_path << "**\n";
+
+        // Add summary if available
+        std::string file_summary_text = file_info.value("summary", "");
+        if (!file_summary_text.empty()) {
+            summary << "- Summary: " << file_summary_text << "\n";
+        } else {
+            summary << "- Summary: Code file (no detailed summary available)\n";
+        }
+
+        // Add analysis details if available
+        if (file_info.contains("analysis")) {
+            const auto& analysis = file_info["analysis"];
+
+            // File type and lines
+            if (analysis.contains("type") || analysis.contains("lines")) {
+                summary << "- Type: " << analysis.value("type", "unknown")
+                       << " (" << analysis.value("lines", 0) << " lines)\n";
+            }
+
+            // Functions
+            if (analysis.contains("functions") && !analysis["functions"].empty()) {
+                summary << "- Key Functions: ";
+                int count = 0;
+                for (const auto& func : analysis["functions"]) {
+                    if (count++ >= 5) {
+                        summary << "...";
+                        break;
+                    }
+                    summary << "`" << func.get<std::string>() << "`";
+                    if (count < analysis["functions"].size() && count < 5) {
+                        summary << ", ";
+                    }
+                }
+                summary << "\n";
+            }
+
+            // Classes
+            if (analysis.contains("classes") && !analysis["classes"].empty()) {
+                summary << "- Classes: ";
+                int count = 0;
+                for (const auto& cls : analysis["classes"]) {
+                    if (count++ >= 5) {
+                        summary << "...";
+                        break;
+                    }
+                    summary << "`" << cls.get<std::string>() << "`";
+                    if (count < analysis["classes"].size() && count < 5) {
+                        summary << ", ";
+                    }
+                }
+                summary << "\n";
+            }
+
+            // Imports/Dependencies
+            if (analysis.contains("imports") && !analysis["imports"].empty()) {
+                summary << "- Dependencies: ";
+                int count = 0;
+                for (const auto& imp : analysis["imports"]) {
+                    if (count++ >= 3) {
+                        summary << "...";
+                        break;
+                    }
+                    summary << "`" << imp.get<std::string>() << "`";
+                    if (count < analysis["imports"].size() && count < 3) {
+                        summary << ", ";
+                    }
+                }
+                summary << "\n";
+            }
+        }
+
+        // Near-duplicates this entry stands for
+        if (file_info.contains("near_duplicates")) {
+            const auto& members = file_info["near_duplicates"];
+            summary << "- Near-duplicates: " << members.size() << " more files like this (";
+            size_t shown = std::min<size_t>(members.size(), 3);
+            for (size_t i = 0; i < shown; ++i) {
+                summary << "`" << members[i].get<std::string>() << "`" << (i + 1 < shown ? ", " : "");
+            }
+            summary << (members.size() > shown ? ", ...)" : ")") << "\n";
+        }
+
+        summary << "\n";
+        return summary.str();
+    }
+
+    // Build key files summary with analysis
+    static std::string buildKeyFilesSummary(const json& repo_data) {
+        if (!repo_data.contains("files")) {
+            return "No file analysis available.\n";
+        }
+        return renderKeyFilesSummary(categorizeFiles(repo_data["files"]), repo_data["files"]);
+    }
+
+    // Category -> file paths, in the order categories are rendered. Uses the category the
+    // scanner stored per file, categorizing only entries from older summaries.
+    static std::map<std::string, std::vector<std::string>> categorizeFiles(const json& files) {
+        std::map<std::string, std::vector<std::string>> organized;
+        for (auto& [file_path, file_info] : files.items()) {
+            auto category = file_info.find("category");
+            if (category != file_info.end() && category->is_string()) {
+                organized[category->get<std::string>()].push_back(file_path);
+            } else {
+                organized[categorizeFile(file_path, file_info)].push_back(file_path);
+            }
+        }
+        return organized;
+    }
+
+    static std::string renderKeyFilesSummary(
+        const std::map<std::string, std::vector<std::string>>& organized,
+        const json& files
+    ) {
+        std::ostringstream summary;
+
+        // Build summary for each category
+        int total_files_documented = 0;
+        for (const auto& [category, paths] : organized) {
+            if (paths.empty()) continue;
+
+            summary << "### " << category << "\n\n";
+
+            for (const auto& file_path : paths) {
+                if (isNearDuplicate(files[file_path])) continue;
+                summary << renderKeyFile(file_path, files[file_path]);
+                total_files_documented++;
+            }
+        }
+
+        // If no files were categorized, return a helpful message
+        if (total_files_documented == 0) {
+            return "**Note:** No key components were identified in the repository analysis. "
+                   "This may indicate that the repository scanning did not capture file summaries, "
+                   "or the files don't match common component patterns.\n\n";
+        }
+
+        return summary.str();
+    }
+
+    // Everything prompt assembly needs, precomputed from scan results
+    static json buildContext(const json& repo_data) {
+        json context;
+        context["version"] = VERSION;
+
+        std::map<std::string, int> languages;
+        int total_lines = 0;
+        std::map<std::string, std::vector<std::string>> organized;
+        if (repo_data.contains("files")) {
+            for (auto& [file_path, file_info] : repo_data["files"].items()) {
+                if (file_info.contains("analysis")) {
+                    total_lines += file_info["analysis"].value("lines", 0);
+                    languages[file_info["analysis"].value("type", "unknown")]++;
+                }
+            }
+            organized = categorizeFiles(repo_data["files"]);
+        }
+
+        // Fingerprint of the analyzed files; anything derived from them (e.g. generated docs) keys on it
+        context["content_hash"] = ContentHash::sha256(repo_data.contains("files") ? repo_data["files"].dump() : "");
+        context["languages"] = languages;
+        context["total_lines"] = total_lines;
+        context["categories"] = organized;
+        context["overview"] = buildRepositoryOverview(repo_data);
+        context["file_structure"] = buildFileStructure(repo_data);
+        context["key_files_summary"] = repo_data.contains("files")
+            ? renderKeyFilesSummary(organized, repo_data["files"])
+            : "No file analysis available.\n";
+        return context;
+    }
+
+    // Stored context if it is current, otherwise built now
+    static json getContext(const json& repo_data) {
+        if (repo_data.contains("context") && repo_data["context"].value("version", 0) == VERSION) {
+            return repo_data["context"];
+        }
+        return buildContext(repo_data);
+    }
+};
+
+#endif // CONTEXT_BUILDER_H
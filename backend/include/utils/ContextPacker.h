@@ -0,0 +1,281 @@
+#ifndef CONTEXT_PACKER_H
+#define CONTEXT_PACKER_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
+#include <nlohmann/json.hpp>
+#include "ContextBuilder.h"
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+struct PackedContext {
+    std::string overview;
+    std::string file_structure;
+    std::string key_files_summary;
+    int estimated_tokens = 0;
+    int budget_tokens = 0;
+    std::string structure_mode;     // "full", "rollup" or "directories"
+    size_t key_files_detailed = 0;  // files with a full summary entry
+    size_t key_files_listed = 0;    // files mentioned by path only
+    size_t key_files_total = 0;
+};
+
+// Fits the precomputed repository context into a token budget (the model's
+// context window minus num_predict and the fixed prompt text). Small
+// repositories pass through unchanged; larger ones degrade in steps: the
+// file tree collapses into per-directory rollups, and key files are ranked by
+// category and richness so the most informative get full entries, the next
+// ones a path-only mention, and the rest a count.
+class ContextPacker {
+public:
+    // Rough token estimate for English/code text (about four characters per token)
+    static int estimateTokens(const std::string& text) {
+        return static_cast<int>((text.size() + CHARS_PER_TOKEN - 1) / CHARS_PER_TOKEN);
+    }
+
+    // priority lists files to pack ahead of the category ranking, best first (e.g. the
+    // files retrieved for a doc type by embedding similarity)
+    static PackedContext pack(const json& repo_data, const json& context, int budget_tokens,
+                              const std::vector<std::string>& priority = {}) {
+        PackedContext packed;
+        packed.budget_tokens = budget_tokens;
+        packed.overview = context["overview"].get<std::string>();
+
+        const json empty_files = json::object();
+        const json& files = repo_data.contains("files") ? repo_data["files"] : empty_files;
+        // Near-duplicates ride along with their representative's entry
+        for (auto& [_, file_info] : files.items()) {
+            if (!ContextBuilder::isNearDuplicate(file_info)) packed.key_files_total++;
+        }
+
+        const std::string& full_structure = context["file_structure"].get_ref<const std::string&>();
+        const std::string& full_key_files = context["key_files_summary"].get_ref<const std::string&>();
+
+        // Leave headroom for the estimate being optimistic
+        int available = budget_tokens - budget_tokens / 10 - estimateTokens(packed.overview);
+        if (estimateTokens(full_structure) + estimateTokens(full_key_files) <= available) {
+            packed.file_structure = full_structure;
+            packed.key_files_summary = full_key_files;
+            packed.structure_mode = "full";
+            packed.key_files_detailed = packed.key_files_total;
+        } else {
+            // Structure gets at most a quarter up front; key files carry more signal per token
+            int structure_allowance = std::max(0, available / 4);
+            packed.file_structure = packStructure(full_structure, files, structure_allowance, packed.structure_mode);
+            int structure_tokens = estimateTokens(packed.file_structure);
+
+            packed.key_files_summary = packKeyFiles(context, files, available - structure_tokens, priority, packed);
+
+            // Hand whatever key files left over back to a degraded structure
+            int leftover = available - structure_tokens - estimateTokens(packed.key_files_summary);
+            if (packed.structure_mode != "full" && leftover > 0) {
+                packed.file_structure = packStructure(full_structure, files, structure_tokens + leftover,
+                                                      packed.structure_mode);
+            }
+        }
+
+        packed.estimated_tokens = estimateTokens(packed.overview) + estimateTokens(packed.file_structure) +
+                                  estimateTokens(packed.key_files_summary);
+        return packed;
+    }
+
+    // Full tree, then per-directory rollups with fewer names, then the largest directories only
+    static std::string packStructure(const std::string& full_structure, const json& files,
+                                     int allowance, std::string& mode) {
+        if (estimateTokens(full_structure) <= allowance) {
+            mode = "full";
+            return full_structure;
+        }
+
+        auto dirs = directoryListing(files);
+        mode = "rollup";
+        for (size_t names_per_dir : {5, 2, 0}) {
+            std::ostringstream rollup;
+            for (const auto& [dir, names] : dirs) {
+                rollup << "**" << dir << "/** (" << names.size() << " files)\n";
+                size_t shown = std::min(names_per_dir, names.size());
+                for (size_t i = 0; i < shown; ++i) {
+                    rollup << "  - " << names[i] << "\n";
+                }
+                if (shown > 0 && names.size() > shown) {
+                    rollup << "  - ... " << (names.size() - shown) << " more\n";
+                }
+                if (shown > 0) rollup << "\n";
+            }
+            if (estimateTokens(rollup.str()) <= allowance) return rollup.str();
+        }
+
+        mode = "directories";
+        std::vector<std::pair<std::string, size_t>> by_size;
+        for (const auto& [dir, names] : dirs) by_size.push_back({dir, names.size()});
+        std::stable_sort(by_size.begin(), by_size.end(),
+                         [](const auto& a, const auto& b) { return a.second > b.second; });
+
+        std::string result;
+        size_t included = 0;
+        for (const auto& [dir, count] : by_size) {
+            std::string line = "- " + dir + "/ (" + std::to_string(count) + " files)\n";
+            if (estimateTokens(result + line) + 8 > allowance) break;
+            result += line;
+            included++;
+        }
+        if (included < by_size.size()) {
+            result += "- ... " + std::to_string(by_size.size() - included) + " more directories\n";
+        }
+        return result;
+    }
+
+private:
+    static constexpr size_t CHARS_PER_TOKEN = 4;
+
+    // Lower ranks are packed first
+    static int categoryRank(const std::string& category) {
+        static const std::map<std::string, int> ranks = {
+            {"Entry Points", 0},
+            {"API Routes & Controllers", 1},
+            {"Services & Business Logic", 2},
+            {"Models & Data Structures", 3},
+            {"Algorithms & Computations", 4},
+            {"Data Pipeline & Processing", 5},
+            {"Configuration", 6},
+            {"Utilities & Helpers", 7},
+            {"Other Components", 8},
+            {"Tests", 9}
+        };
+        auto it = ranks.find(category);
+        return it != ranks.end() ? it->second : 8;
+    }
+
+    static size_t richness(const json& file_info) {
+        if (!file_info.contains("analysis")) return 0;
+        const auto& analysis = file_info["analysis"];
+        size_t classes = analysis.contains("classes") ? analysis["classes"].size() : 0;
+        size_t functions = analysis.contains("functions") ? analysis["functions"].size() : 0;
+        return classes * 2 + functions;
+    }
+
+    static std::map<std::string, std::vector<std::string>> directoryListing(const json& files) {
+        std::map<std::string, std::vector<std::string>> dirs;
+        for (auto& [file_path, file_info] : files.items()) {
+            if (ContextBuilder::isNearDuplicate(file_info)) continue;
+            fs::path p(file_path);
+            std::string dir = p.parent_path().string();
+            if (dir.empty()) dir = ".";
+            dirs[dir].push_back(p.filename().string());
+        }
+        return dirs;
+    }
+
+    static std::string packKeyFiles(const json& context, const json& files, int allowance,
+                                    const std::vector<std::string>& priority, PackedContext& packed) {
+        std::map<std::string, std::vector<std::string>> categories;
+        if (context.contains("categories")) {
+            categories = context["categories"].get<std::map<std::string, std::vector<std::string>>>();
+        } else {
+            categories = ContextBuilder::categorizeFiles(files);
+        }
+
+        std::map<std::string, size_t> priority_rank;
+        for (size_t i = 0; i < priority.size(); ++i) priority_rank.emplace(priority[i], i);
+
+        struct Candidate {
+            std::string path;
+            std::string category;
+            size_t priority;    // position in the priority list, or past its end
+            int rank;
+            size_t richness;
+        };
+        std::vector<Candidate> ranked;
+        for (const auto& [category, paths] : categories) {
+            for (const auto& path : paths) {
+                if (!files.contains(path) || ContextBuilder::isNearDuplicate(files[path])) continue;
+                auto prioritized = priority_rank.find(path);
+                ranked.push_back({path, category,
+                                  prioritized != priority_rank.end() ? prioritized->second : priority.size(),
+                                  categoryRank(category), richness(files[path])});
+            }
+        }
+        std::sort(ranked.begin(), ranked.end(), [](const Candidate& a, const Candidate& b) {
+            if (a.priority != b.priority) return a.priority < b.priority;
+            if (a.rank != b.rank) return a.rank < b.rank;
+            if (a.richness != b.richness) return a.richness > b.richness;
+            return a.path < b.path;
+        });
+
+        // Pass 1: full entries in rank order; pass 2: path-only mentions with what is left
+        std::map<std::string, std::vector<std::string>> detailed;
+        std::map<std::string, std::vector<std::string>> listed;
+        std::map<std::string, size_t> omitted;
+        int used = 0;
+        std::map<std::string, bool> header_paid;
+        auto headerCost = [&](const std::string& category) {
+            // "### <category>\n\n" plus a trailing "... N more" line
+            return header_paid[category] ? 0 : estimateTokens("### " + category + "\n\n") + 8;
+        };
+
+        std::vector<const Candidate*> remaining;
+        for (const auto& candidate : ranked) {
+            int cost = estimateTokens(ContextBuilder::renderKeyFile(candidate.path, files[candidate.path])) +
+                       headerCost(candidate.category);
+            if (used + cost <= allowance) {
+                used += cost;
+                header_paid[candidate.category] = true;
+                detailed[candidate.category].push_back(candidate.path);
+            } else {
+                remaining.push_back(&candidate);
+            }
+        }
+        for (const auto* candidate : remaining) {
+            int cost = estimateTokens("`" + candidate->path + "`, ") + headerCost(candidate->category) + 4;
+            if (used + cost <= allowance) {
+                used += cost;
+                header_paid[candidate->category] = true;
+                listed[candidate->category].push_back(candidate->path);
+            } else {
+                omitted[candidate->category]++;
+            }
+        }
+
+        std::ostringstream summary;
+        for (const auto& [category, _] : categories) {
+            bool has_detail = detailed.count(category) > 0;
+            bool has_listed = listed.count(category) > 0;
+            if (!has_detail && !has_listed) continue;
+
+            summary << "### " << category << "\n\n";
+            if (has_detail) {
+                for (const auto& path : detailed[category]) {
+                    summary << ContextBuilder::renderKeyFile(path, files[path]);
+                }
+            }
+            if (has_listed) {
+                summary << "Also in this category: ";
+                for (size_t i = 0; i < listed[category].size(); ++i) {
+                    summary << "`" << listed[category][i] << "`" << (i + 1 < listed[category].size() ? ", " : "");
+                }
+                summary << "\n";
+            }
+            if (omitted[category] > 0) {
+                summary << "- ... " << omitted[category] << " more files not shown\n";
+            }
+            summary << "\n";
+        }
+
+        size_t total_omitted = 0;
+        for (const auto& [_, count] : omitted) total_omitted += count;
+        if (total_omitted > 0) {
+            summary << "*" << total_omitted << " lower-priority files omitted to fit the model's context window.*\n\n";
+        }
+
+        for (const auto& [_, paths] : detailed) packed.key_files_detailed += paths.size();
+        for (const auto& [_, paths] : listed) packed.key_files_listed += paths.size();
+        return summary.str();
+    }
+};
+
+#endif // CONTEXT_PACKER_H
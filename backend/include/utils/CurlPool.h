@@ -0,0 +1,123 @@
+#ifndef CURL_POOL_H
+#define CURL_POOL_H
+
+#include <vector>
+#include <mutex>
+#include <stdexcept>
+#include <curl/curl.h>
+
+// Reusable CURL easy handles for talking to one HTTP service. A released
+// handle is reset and kept for the next request, and all handles share one
+// DNS cache and one connection cache through a CURLSH, so consecutive calls
+// reuse a kept-alive TCP connection instead of resolving and connecting again.
+// At most max_idle handles are kept; extra handles from bursts are closed.
+class CurlPool {
+public:
+    // Borrowed handle; returned to the pool when it goes out of scope
+    class Handle {
+    public:
+        Handle(CurlPool* pool, CURL* curl) : pool(pool), curl(curl) {}
+        Handle(Handle&& other) noexcept : pool(other.pool), curl(other.curl) { other.curl = nullptr; }
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+        Handle& operator=(Handle&&) = delete;
+        ~Handle() {
+            if (curl) pool->release(curl);
+        }
+
+        CURL* get() const { return curl; }
+
+    private:
+        CurlPool* pool;
+        CURL* curl;
+    };
+
+    explicit CurlPool(size_t max_idle = 8) : max_idle(max_idle) {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+
+        share = curl_share_init();
+        if (share) {
+            curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockShare);
+            curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockShare);
+            curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        }
+
+        json_headers = curl_slist_append(nullptr, "Content-Type: application/json");
+    }
+
+    ~CurlPool() {
+        for (CURL* curl : idle) curl_easy_cleanup(curl);
+        if (share) curl_share_cleanup(share);
+        curl_slist_free_all(json_headers);
+        curl_global_cleanup();
+    }
+
+    CurlPool(const CurlPool&) = delete;
+    CurlPool& operator=(const CurlPool&) = delete;
+
+    // A handle with default options apart from the pool's connection settings
+    Handle acquire() {
+        CURL* curl = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!idle.empty()) {
+                curl = idle.back();
+                idle.pop_back();
+            }
+        }
+
+        if (!curl) {
+            curl = curl_easy_init();
+            if (!curl) {
+                throw std::runtime_error("Failed to initialize CURL");
+            }
+            // Survives curl_easy_reset, so it is set once per handle
+            if (share) curl_easy_setopt(curl, CURLOPT_SHARE, share);
+        }
+
+        // Timeouts must not use signals from worker threads
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        // Keep a connection per pooled handle; curl's default of 5 churns under more concurrency
+        curl_easy_setopt(curl, CURLOPT_MAXCONNECTS, static_cast<long>(max_idle));
+        return Handle(this, curl);
+    }
+
+    // "Content-Type: application/json", built once and valid for the pool's lifetime
+    curl_slist* jsonHeaders() const {
+        return json_headers;
+    }
+
+private:
+    size_t max_idle;
+    CURLSH* share = nullptr;
+    curl_slist* json_headers = nullptr;
+    std::mutex mutex;
+    std::vector<CURL*> idle;
+    std::mutex share_locks[CURL_LOCK_DATA_LAST];
+
+    void release(CURL* curl) {
+        // Clears options and per-request state; shared caches and connections stay
+        curl_easy_reset(curl);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (idle.size() < max_idle) {
+                idle.push_back(curl);
+                return;
+            }
+        }
+        curl_easy_cleanup(curl);
+    }
+
+    static void lockShare(CURL*, curl_lock_data data, curl_lock_access, void* userp) {
+        static_cast<CurlPool*>(userp)->share_locks[data].lock();
+    }
+
+    static void unlockShare(CURL*, curl_lock_data data, void* userp) {
+        static_cast<CurlPool*>(userp)->share_locks[data].unlock();
+    }
+};
+
+#endif // CURL_POOL_H
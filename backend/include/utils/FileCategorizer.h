@@ -0,0 +1,299 @@
+#ifndef FILE_CATEGORIZER_H
+#define FILE_CATEGORIZER_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <array>
+#include <queue>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// Aho-Corasick automaton over a fixed keyword list. Matching is case-insensitive
+// (case folding lives in the byte -> symbol table, so the input is never copied)
+// and reports every keyword found in one pass as a bitmask, bit i = keywords[i].
+class KeywordAutomaton {
+private:
+    std::array<uint8_t, 256> symbol_of{};     // byte -> symbol; 0 for bytes no keyword uses
+    size_t symbol_count = 1;
+    std::vector<int32_t> transitions;         // state * symbol_count + symbol -> state
+    std::vector<uint64_t> outputs;            // keywords ending at (or suffix-linked from) a state
+
+public:
+    static constexpr size_t MAX_KEYWORDS = 64;
+
+    explicit KeywordAutomaton(const std::vector<std::string>& keywords) {
+        if (keywords.size() > MAX_KEYWORDS) {
+            throw std::invalid_argument("KeywordAutomaton supports at most 64 keywords");
+        }
+
+        for (const auto& keyword : keywords) {
+            for (unsigned char c : keyword) {
+                unsigned char lower = static_cast<unsigned char>(std::tolower(c));
+                if (symbol_of[lower] == 0) {
+                    symbol_of[lower] = static_cast<uint8_t>(symbol_count++);
+                    symbol_of[static_cast<unsigned char>(std::toupper(lower))] = symbol_of[lower];
+                }
+            }
+        }
+
+        // Trie; -1 marks a missing edge until the failure links fill it in
+        transitions.assign(symbol_count, -1);
+        outputs.assign(1, 0);
+        for (size_t i = 0; i < keywords.size(); ++i) {
+            int32_t state = 0;
+            for (unsigned char c : keywords[i]) {
+                size_t edge = state * symbol_count + symbol_of[c];
+                if (transitions[edge] < 0) {
+                    transitions[edge] = static_cast<int32_t>(outputs.size());
+                    outputs.push_back(0);
+                    transitions.resize(transitions.size() + symbol_count, -1);
+                }
+                state = transitions[edge];
+            }
+            outputs[state] |= uint64_t{1} << i;
+        }
+
+        // Breadth-first: complete the goto function into a DFA and merge suffix outputs
+        std::vector<int32_t> failure(outputs.size(), 0);
+        std::queue<int32_t> pending;
+        for (size_t s = 0; s < symbol_count; ++s) {
+            int32_t& next = transitions[s];
+            if (next < 0) {
+                next = 0;
+            } else {
+                pending.push(next);
+            }
+        }
+        while (!pending.empty()) {
+            int32_t state = pending.front();
+            pending.pop();
+            outputs[state] |= outputs[failure[state]];
+            for (size_t s = 0; s < symbol_count; ++s) {
+                int32_t& next = transitions[state * symbol_count + s];
+                int32_t fallback = transitions[failure[state] * symbol_count + s];
+                if (next < 0) {
+                    next = fallback;
+                } else {
+                    failure[next] = fallback;
+                    pending.push(next);
+                }
+            }
+        }
+    }
+
+    uint64_t match(const std::string& text) const {
+        uint64_t hits = 0;
+        int32_t state = 0;
+        for (unsigned char c : text) {
+            state = transitions[state * symbol_count + symbol_of[c]];
+            hits |= outputs[state];
+        }
+        return hits;
+    }
+};
+
+// Keyword-driven file classification shared by the scanner (file purpose) and
+// prompt/fallback documentation (component categories, directory roles). Each
+// rule set keeps its original first-match order; the keyword tests behind it
+// run as one automaton pass per field instead of a chain of find() calls.
+class FileCategorizer {
+public:
+    // Component category used to group key files ("Entry Points", "Tests", ...)
+    static std::string categorize(const std::string& file_path, const std::string& summary) {
+        static const RuleSet rules({
+            {"Entry Points",
+             {"entry point", "main application"}, {}, {},
+             {"main.py", "app.py", "index.js", "main.cpp", "main.java", "server.js", "index.ts", "main.go"}, {}},
+            {"Models & Data Structures",
+             {"model", "schema", "entity", "data structure"}, {}, {"model", "entity", "schema"}, {}, {}},
+            {"Services & Business Logic",
+             {"service", "business logic", "handler"}, {"service"}, {"service"}, {}, {}},
+            {"API Routes & Controllers",
+             {"controller", "route", "api", "endpoint"}, {}, {"route", "controller", "api"}, {}, {}},
+            {"Algorithms & Computations",
+             {"algorithm", "computation", "calculation"}, {}, {"algorithm", "compute"}, {}, {}},
+            {"Utilities & Helpers",
+             {"utility", "helper", "util"}, {"util"}, {"util", "helper"}, {}, {}},
+            {"Configuration",
+             {"config"}, {"config"}, {},
+             {"docker-compose.yml", "Dockerfile"}, {".env", ".yml", ".yaml", ".toml"}},
+            {"Tests",
+             {"test"}, {"test", "spec"}, {"test"}, {}, {}},
+            {"Data Pipeline & Processing",
+             {"pipeline", "processing"}, {}, {"pipeline", "data"}, {}, {}}
+        }, "Other Components");
+
+        fs::path path(file_path);
+        return rules.classify(summary, path.filename().string(), path.parent_path().string(),
+                              path.extension().string());
+    }
+
+    // Role of a directory for the architecture overview
+    static std::string directoryRole(const std::string& directory) {
+        static const RuleSet rules({
+            {"Data models and schemas", {}, {}, {"model"}, {}, {}},
+            {"Business logic and services", {}, {}, {"service"}, {}, {}},
+            {"API endpoints and routing", {}, {}, {"api", "route"}, {}, {}},
+            {"Utility functions and helpers", {}, {}, {"util", "helper"}, {}, {}},
+            {"Test files", {}, {}, {"test"}, {}, {}},
+            {"Configuration files", {}, {}, {"config"}, {}, {}},
+            {"Data processing and pipeline components", {}, {}, {"pipeline", "data"}, {}, {}},
+            {"Algorithms and computational logic", {}, {}, {"algorithm"}, {}, {}}
+        }, "Component files");
+
+        return rules.classify("", "", directory, "");
+    }
+
+    // One-line purpose the scanner puts at the start of each file summary
+    static std::string filePurpose(const std::string& file_path) {
+        static const RuleSet rules({
+            {"Test file - Contains unit tests and test cases", {}, {"test", "spec"}, {}, {}, {}},
+            {"Configuration file - Stores application settings", {}, {"config"}, {},
+             {"settings.py", ".env"}, {}},
+            {"Package initializer - Makes directory a Python package", {}, {}, {}, {"__init__.py"}, {}},
+            {"Entry point - Main application file", {}, {}, {},
+             {"main.py", "app.py", "index.js", "server.js", "index.ts", "main.cpp"}, {}},
+            {"Data model - Defines data structures and database schemas", {}, {"model", "schema"}, {}, {}, {}},
+            {"Service layer - Contains business logic", {}, {"service"}, {}, {}, {}},
+            {"Controller/Router - Handles HTTP requests and routing", {}, {"controller", "route"}, {}, {}, {}},
+            {"Utility file - Helper functions and utilities", {}, {"util", "helper"}, {}, {}, {}},
+            {"Type definitions - TypeScript types and interfaces", {}, {"type", "interface"}, {}, {}, {}}
+        }, "Source file - Contains application code");
+
+        // Exact names compare case-insensitively here
+        std::string filename = fs::path(file_path).filename().string();
+        std::transform(filename.begin(), filename.end(), filename.begin(), ::tolower);
+        return rules.classify("", filename, "", "");
+    }
+
+    // Component categories a documentation section is about, from its title: every category
+    // whose keywords occur. Empty means the section covers the whole repository.
+    static std::vector<std::string> sectionCategories(const std::string& section_title) {
+        static const std::vector<std::pair<std::string, std::vector<std::string>>> topics = {
+            {"Entry Points", {"entry point", "quick start", "getting started"}},
+            {"API Routes & Controllers", {"endpoint", "api", "route", "request", "webhook", "authentication",
+                                          "authorization", "rate limit", "integration", "sdk"}},
+            {"Services & Business Logic", {"service", "feature", "workflow", "business", "usage"}},
+            {"Models & Data Structures", {"schema", "table", "collection", "model", "entity", "database",
+                                          "quer", "migration"}},
+            {"Configuration", {"config", "install", "setup", "environment", "deploy", "system requirement",
+                               "settings", "upgrad", "prerequisite", "dependenc"}},
+            {"Tests", {"test", "acceptance", "quality"}},
+            {"Utilities & Helpers", {"util", "helper", "naming", "convention", "standard"}},
+            {"Algorithms & Computations", {"algorithm", "computation", "performance"}},
+            {"Data Pipeline & Processing", {"pipeline", "processing"}}
+        };
+        // Overview-style sections describe everything even when a topic keyword appears
+        static const std::vector<std::string> whole_repository = {
+            "overview", "summary", "architecture", "structure", "welcome", "introduction", "context",
+            "strategy", "building block", "risk", "faq", "glossary"
+        };
+
+        static const auto compiled = [] {
+            std::vector<std::string> keywords(whole_repository);
+            std::vector<std::pair<std::string, uint64_t>> masks;
+            for (const auto& [category, words] : topics) {
+                uint64_t mask = 0;
+                for (const auto& word : words) {
+                    mask |= uint64_t{1} << keywords.size();
+                    keywords.push_back(word);
+                }
+                masks.push_back({category, mask});
+            }
+            return std::make_pair(KeywordAutomaton(keywords), masks);
+        }();
+
+        uint64_t hits = compiled.first.match(section_title);
+        std::vector<std::string> categories;
+        if (hits & ((uint64_t{1} << whole_repository.size()) - 1)) return categories;
+        for (const auto& [category, mask] : compiled.second) {
+            if (hits & mask) categories.push_back(category);
+        }
+        return categories;
+    }
+
+private:
+    // A rule matches if any of its keywords occurs in the named field (case-insensitive),
+    // or the filename / extension equals one of the listed values exactly
+    struct Rule {
+        std::string label;
+        std::vector<std::string> summary_keywords;
+        std::vector<std::string> filename_keywords;
+        std::vector<std::string> directory_keywords;
+        std::set<std::string> names;
+        std::set<std::string> extensions;
+    };
+
+    class RuleSet {
+    private:
+        struct CompiledRule {
+            std::string label;
+            uint64_t summary_mask = 0;
+            uint64_t filename_mask = 0;
+            uint64_t directory_mask = 0;
+            std::set<std::string> names;
+            std::set<std::string> extensions;
+        };
+
+        std::vector<CompiledRule> rules;
+        std::string fallback;
+        // Masks are filled while the matchers are compiled, so they are declared first
+        std::vector<uint64_t> summary_masks;
+        std::vector<uint64_t> filename_masks;
+        std::vector<uint64_t> directory_masks;
+        KeywordAutomaton summary_matcher;
+        KeywordAutomaton filename_matcher;
+        KeywordAutomaton directory_matcher;
+
+        // Automaton over the distinct keywords of one field, plus each rule's bitmask over them
+        static KeywordAutomaton compile(const std::vector<Rule>& source, std::vector<std::string> Rule::*field,
+                                        std::vector<uint64_t>& masks) {
+            std::vector<std::string> keywords;
+            masks.assign(source.size(), 0);
+            for (size_t r = 0; r < source.size(); ++r) {
+                for (const auto& keyword : source[r].*field) {
+                    auto it = std::find(keywords.begin(), keywords.end(), keyword);
+                    size_t bit = it - keywords.begin();
+                    if (it == keywords.end()) keywords.push_back(keyword);
+                    masks[r] |= uint64_t{1} << bit;
+                }
+            }
+            return KeywordAutomaton(keywords);
+        }
+
+    public:
+        RuleSet(const std::vector<Rule>& source, const std::string& fallback_label)
+            : fallback(fallback_label),
+              summary_matcher(compile(source, &Rule::summary_keywords, summary_masks)),
+              filename_matcher(compile(source, &Rule::filename_keywords, filename_masks)),
+              directory_matcher(compile(source, &Rule::directory_keywords, directory_masks)) {
+            for (size_t r = 0; r < source.size(); ++r) {
+                rules.push_back({source[r].label, summary_masks[r], filename_masks[r], directory_masks[r],
+                                 source[r].names, source[r].extensions});
+            }
+        }
+
+        std::string classify(const std::string& summary, const std::string& filename,
+                             const std::string& directory, const std::string& extension) const {
+            uint64_t summary_hits = summary.empty() ? 0 : summary_matcher.match(summary);
+            uint64_t filename_hits = filename.empty() ? 0 : filename_matcher.match(filename);
+            uint64_t directory_hits = directory.empty() ? 0 : directory_matcher.match(directory);
+
+            for (const auto& rule : rules) {
+                if ((summary_hits & rule.summary_mask) || (filename_hits & rule.filename_mask) ||
+                    (directory_hits & rule.directory_mask) || rule.names.count(filename) ||
+                    rule.extensions.count(extension)) {
+                    return rule.label;
+                }
+            }
+            return fallback;
+        }
+    };
+};
+
+#endif // FILE_CATEGORIZER_H
@@ -0,0 +1,211 @@
+#ifndef GIT_OBJECT_READER_H
+#define GIT_OBJECT_READER_H
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+struct GitTreeEntry {
+    std::string mode;
+    std::string oid;
+    std::string path;
+    long long size;
+};
+
+// Reads trees and blobs straight from a git object database without a working
+// tree. Blob contents stream through one long-lived `git cat-file --batch`
+// process, so a whole scan costs a single fork regardless of file count.
+class GitObjectReader {
+private:
+    std::string git_dir;
+    pid_t pid = -1;
+    FILE* batch_in = nullptr;
+    FILE* batch_out = nullptr;
+
+    static std::string shellQuote(const std::string& value) {
+        std::string quoted = "'";
+        for (char c : value) {
+            if (c == '\'') quoted += "'\\''";
+            else quoted += c;
+        }
+        return quoted + "'";
+    }
+
+    void startBatchProcess() {
+        int to_child[2];
+        int from_child[2];
+        if (pipe2(to_child, O_CLOEXEC) != 0) {
+            throw std::runtime_error("Failed to create pipe for git cat-file");
+        }
+        if (pipe2(from_child, O_CLOEXEC) != 0) {
+            close(to_child[0]);
+            close(to_child[1]);
+            throw std::runtime_error("Failed to create pipe for git cat-file");
+        }
+
+        // The child of a multithreaded process may only call async-signal-safe functions,
+        // so the arguments are built before fork()
+        std::string git_dir_arg = "--git-dir=" + git_dir;
+        char* const argv[] = {
+            const_cast<char*>("git"), const_cast<char*>(git_dir_arg.c_str()),
+            const_cast<char*>("cat-file"), const_cast<char*>("--batch"), nullptr
+        };
+
+        pid = fork();
+        if (pid < 0) {
+            close(to_child[0]); close(to_child[1]);
+            close(from_child[0]); close(from_child[1]);
+            throw std::runtime_error("Failed to start git cat-file");
+        }
+
+        if (pid == 0) {
+            dup2(to_child[0], STDIN_FILENO);
+            dup2(from_child[1], STDOUT_FILENO);
+            execvp("git", argv);
+            _exit(127);
+        }
+
+        close(to_child[0]);
+        close(from_child[1]);
+        batch_in = fdopen(to_child[1], "w");
+        batch_out = fdopen(from_child[0], "r");
+    }
+
+    void stopBatchProcess() {
+        if (batch_in) fclose(batch_in);
+        if (batch_out) fclose(batch_out);
+        batch_in = nullptr;
+        batch_out = nullptr;
+
+        if (pid > 0) {
+            int status;
+            waitpid(pid, &status, 0);
+            pid = -1;
+        }
+    }
+
+    // Send one request line and parse the "<oid> <type> <size>" header; returns -1 if missing
+    long long requestObject(const std::string& object_name, std::string& type) {
+        if (fputs((object_name + "\n").c_str(), batch_in) < 0 || fflush(batch_in) != 0) {
+            throw std::runtime_error("git cat-file process is not accepting requests");
+        }
+
+        std::string header;
+        int c;
+        while ((c = fgetc(batch_out)) != EOF && c != '\n') {
+            header += static_cast<char>(c);
+        }
+        if (c == EOF) {
+            throw std::runtime_error("git cat-file process exited unexpectedly");
+        }
+
+        if (header.size() >= 8 && header.compare(header.size() - 8, 8, " missing") == 0) {
+            return -1;
+        }
+
+        size_t first_space = header.find(' ');
+        size_t second_space = header.find(' ', first_space + 1);
+        if (first_space == std::string::npos || second_space == std::string::npos) {
+            throw std::runtime_error("Unexpected git cat-file header: " + header);
+        }
+
+        type = header.substr(first_space + 1, second_space - first_space - 1);
+        return std::stoll(header.substr(second_space + 1));
+    }
+
+public:
+    explicit GitObjectReader(const std::string& repository_git_dir) : git_dir(repository_git_dir) {
+        startBatchProcess();
+    }
+
+    ~GitObjectReader() {
+        stopBatchProcess();
+    }
+
+    GitObjectReader(const GitObjectReader&) = delete;
+    GitObjectReader& operator=(const GitObjectReader&) = delete;
+
+    // Resolve a revision (branch, tag, sha) to a full commit id
+    std::string resolveCommit(const std::string& rev) {
+        std::string cmd = "git --git-dir=" + shellQuote(git_dir) + " rev-parse --verify --quiet " +
+                          shellQuote(rev + "^{commit}") + " 2>/dev/null";
+        FILE* pipe = popen(cmd.c_str(), "r");
+        if (!pipe) {
+            throw std::runtime_error("Failed to run git rev-parse");
+        }
+
+        char buffer[128] = {0};
+        std::string sha;
+        if (fgets(buffer, sizeof(buffer), pipe)) sha = buffer;
+        int status = pclose(pipe);
+
+        sha.erase(sha.find_last_not_of(" \t\r\n") + 1);
+        if (status != 0 || sha.empty()) {
+            throw std::runtime_error("Commit not found in object database: " + rev);
+        }
+        return sha;
+    }
+
+    // List every blob reachable from a commit's tree (recursively, with sizes).
+    // Submodules and symlinks are skipped since there is no file content to analyze.
+    std::vector<GitTreeEntry> listTree(const std::string& commit) {
+        std::string cmd = "git --git-dir=" + shellQuote(git_dir) + " ls-tree -r -z -l --full-tree " +
+                          shellQuote(commit);
+        FILE* pipe = popen(cmd.c_str(), "r");
+        if (!pipe) {
+            throw std::runtime_error("Failed to run git ls-tree");
+        }
+
+        std::vector<GitTreeEntry> entries;
+        std::string record;
+        int c;
+        while ((c = fgetc(pipe)) != EOF) {
+            if (c != '\0') {
+                record += static_cast<char>(c);
+                continue;
+            }
+
+            // "<mode> SP <type> SP <oid> SP+ <size> TAB <path>"
+            size_t tab = record.find('\t');
+            std::string meta = record.substr(0, tab);
+            std::string path = tab != std::string::npos ? record.substr(tab + 1) : "";
+            record.clear();
+
+            char mode[16], type[16], oid[72], size[32];
+            if (sscanf(meta.c_str(), "%15s %15s %71s %31s", mode, type, oid, size) != 4) continue;
+            if (std::string(type) != "blob" || std::string(mode) == "120000") continue;
+
+            entries.push_back({mode, oid, path, std::atoll(size)});
+        }
+
+        if (pclose(pipe) != 0) {
+            throw std::runtime_error("git ls-tree failed for " + commit);
+        }
+        return entries;
+    }
+
+    // Read a blob by object id or "<rev>:<path>"; returns false if it doesn't exist
+    bool readBlob(const std::string& object_name, std::string& content) {
+        std::string type;
+        long long size = requestObject(object_name, type);
+        if (size < 0) return false;
+
+        content.resize(static_cast<size_t>(size));
+        if (size > 0 && fread(&content[0], 1, content.size(), batch_out) != content.size()) {
+            throw std::runtime_error("Short read from git cat-file for " + object_name);
+        }
+        fgetc(batch_out); // trailing newline after the object body
+
+        return type == "blob";
+    }
+};
+
+#endif // GIT_OBJECT_READER_H
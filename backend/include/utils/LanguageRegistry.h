@@ -0,0 +1,74 @@
+#ifndef LANGUAGE_REGISTRY_H
+#define LANGUAGE_REGISTRY_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+
+struct LanguageInfo {
+    std::string extension;
+    std::string analyzer;    // "python", "javascript" or "other"
+};
+
+// Single source of truth for which files the scanner reads. Checkout
+// strategies derive their sparse patterns from the same table, so a file is
+// materialized on disk exactly when the scanner would analyze it.
+class LanguageRegistry {
+public:
+    static const std::vector<LanguageInfo>& getLanguages() {
+        static const std::vector<LanguageInfo> languages = {
+            {".py", "python"},
+            {".js", "javascript"}, {".ts", "javascript"}, {".jsx", "javascript"}, {".tsx", "javascript"},
+            {".java", "other"}, {".cpp", "other"}, {".c", "other"}, {".h", "other"}, {".hpp", "other"},
+            {".go", "other"}, {".rs", "other"}, {".rb", "other"}, {".php", "other"}, {".swift", "other"},
+            {".kt", "other"}, {".cs", "other"}, {".html", "other"},
+            {".css", "other"}, {".scss", "other"}, {".json", "other"}, {".yaml", "other"},
+            {".yml", "other"}, {".md", "other"}, {".sql", "other"}, {".sh", "other"}
+        };
+        return languages;
+    }
+
+    // Check whether the scanner analyzes files with this extension
+    static bool isAnalyzable(const std::string& ext) {
+        return analyzers().count(ext) > 0;
+    }
+
+    // Analyzer used for an extension ("other" for unknown extensions)
+    static std::string getAnalyzer(const std::string& ext) {
+        auto it = analyzers().find(ext);
+        return it != analyzers().end() ? it->second : "other";
+    }
+
+    static std::set<std::string> getExtensions() {
+        std::set<std::string> extensions;
+        for (const auto& language : getLanguages()) {
+            extensions.insert(language.extension);
+        }
+        return extensions;
+    }
+
+    // Non-cone sparse-checkout patterns selecting every analyzable file plus the
+    // root .gitignore, which the scanner reads for ignore patterns
+    static std::vector<std::string> getSparseCheckoutPatterns() {
+        std::vector<std::string> patterns = {"/.gitignore"};
+        for (const auto& language : getLanguages()) {
+            patterns.push_back("*" + language.extension);
+        }
+        return patterns;
+    }
+
+private:
+    static const std::map<std::string, std::string>& analyzers() {
+        static const std::map<std::string, std::string> by_extension = [] {
+            std::map<std::string, std::string> result;
+            for (const auto& language : getLanguages()) {
+                result[language.extension] = language.analyzer;
+            }
+            return result;
+        }();
+        return by_extension;
+    }
+};
+
+#endif // LANGUAGE_REGISTRY_H
@@ -0,0 +1,172 @@
+#ifndef MIN_HASH_H
+#define MIN_HASH_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cctype>
+#include <unordered_map>
+
+// MinHash signature of a file's content: for each of SIGNATURE_SIZE hash
+// functions, the low 16 bits of the smallest hash over the file's set of
+// three-token shingles. The fraction of positions two signatures share
+// estimates the Jaccard similarity of their shingle sets. Generated API
+// clients, copy-pasted components and per-locale resources score well above
+// SIMILARITY_THRESHOLD; unrelated files of one codebase stay far below it even
+// when they share a lot of boilerplate.
+class MinHash {
+public:
+    static constexpr size_t SIGNATURE_SIZE = 64;
+    // Estimated Jaccard similarity at which two files count as near-duplicates
+    static constexpr double SIMILARITY_THRESHOLD = 0.6;
+    // Below this many shingles a signature says too little to compare
+    static constexpr size_t MIN_SHINGLES = 16;
+
+    using Signature = std::array<uint16_t, SIGNATURE_SIZE>;
+
+    // Signature of the content; false if it is too short to compare
+    static bool signature(const std::string& content, Signature& result) {
+        std::vector<uint64_t> tokens;
+        size_t i = 0;
+        while (i < content.size()) {
+            unsigned char c = static_cast<unsigned char>(content[i]);
+            if (std::isspace(c)) {
+                ++i;
+                continue;
+            }
+            // Identifiers and numbers are one token, any other character is its own
+            size_t start = i;
+            if (std::isalnum(c) || c == '_') {
+                while (i < content.size() &&
+                       (std::isalnum(static_cast<unsigned char>(content[i])) || content[i] == '_')) ++i;
+            } else {
+                ++i;
+            }
+            tokens.push_back(fnv1a(content.data() + start, i - start));
+        }
+        if (tokens.size() < MIN_SHINGLES + 2) return false;
+
+        std::array<uint64_t, SIGNATURE_SIZE> minimums;
+        minimums.fill(UINT64_MAX);
+        for (size_t t = 0; t + 2 < tokens.size(); ++t) {
+            uint64_t shingle = mix(tokens[t] ^ mix(tokens[t + 1] ^ mix(tokens[t + 2])));
+            for (size_t k = 0; k < SIGNATURE_SIZE; ++k) {
+                uint64_t hash = mix(shingle + SEEDS_STEP * (k + 1));
+                if (hash < minimums[k]) minimums[k] = hash;
+            }
+        }
+
+        for (size_t k = 0; k < SIGNATURE_SIZE; ++k) result[k] = static_cast<uint16_t>(minimums[k]);
+        return true;
+    }
+
+    // Estimated Jaccard similarity of the shingle sets behind two signatures
+    static double similarity(const Signature& a, const Signature& b) {
+        size_t equal = 0;
+        for (size_t k = 0; k < SIGNATURE_SIZE; ++k) equal += a[k] == b[k];
+        return static_cast<double>(equal) / SIGNATURE_SIZE;
+    }
+
+    static std::string toHex(const Signature& signature) {
+        std::string hex;
+        hex.reserve(SIGNATURE_SIZE * 4);
+        char buf[5];
+        for (uint16_t value : signature) {
+            std::snprintf(buf, sizeof(buf), "%04x", value);
+            hex += buf;
+        }
+        return hex;
+    }
+
+    static bool fromHex(const std::string& hex, Signature& signature) {
+        if (hex.size() != SIGNATURE_SIZE * 4) return false;
+        for (size_t k = 0; k < SIGNATURE_SIZE; ++k) {
+            uint16_t value = 0;
+            for (size_t i = k * 4; i < k * 4 + 4; ++i) {
+                char c = hex[i];
+                int digit = std::isdigit(static_cast<unsigned char>(c)) ? c - '0'
+                          : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+                if (digit < 0) return false;
+                value = static_cast<uint16_t>((value << 4) | digit);
+            }
+            signature[k] = value;
+        }
+        return true;
+    }
+
+private:
+    static constexpr uint64_t SEEDS_STEP = 0x9e3779b97f4a7c15ULL;
+
+    static uint64_t fnv1a(const char* data, size_t length) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // splitmix64 finalizer: spreads FNV's weak low bits over all 64
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+};
+
+// Groups signatures around representatives with banded LSH: signatures are cut
+// into BANDS bands of ROWS positions, and only representatives that match a new
+// signature on a whole band are compared with it. At the similarity threshold a
+// true near-duplicate shares some band with probability 0.89 (0.998 at a
+// typical 0.75). Each added signature joins the most similar representative at
+// or above the threshold or becomes a representative itself, so every member
+// is a near-duplicate of its representative (no chaining).
+class NearDuplicateIndex {
+public:
+    // Index of the representative the signature joins, or -1 if it became one.
+    // Representatives are numbered in the order they were added.
+    long add(const MinHash::Signature& signature) {
+        long best = -1;
+        double best_similarity = MinHash::SIMILARITY_THRESHOLD;
+        for (size_t band = 0; band < BANDS; ++band) {
+            auto it = buckets[band].find(bandKey(signature, band));
+            if (it == buckets[band].end()) continue;
+            for (size_t candidate : it->second) {
+                double similarity = MinHash::similarity(signature, representatives[candidate]);
+                if (similarity > best_similarity ||
+                    (similarity == best_similarity && (best < 0 || static_cast<long>(candidate) < best))) {
+                    best = static_cast<long>(candidate);
+                    best_similarity = similarity;
+                }
+            }
+        }
+        if (best >= 0) return best;
+
+        size_t id = representatives.size();
+        representatives.push_back(signature);
+        for (size_t band = 0; band < BANDS; ++band) {
+            buckets[band][bandKey(signature, band)].push_back(id);
+        }
+        return -1;
+    }
+
+private:
+    static constexpr size_t ROWS = 4;
+    static constexpr size_t BANDS = MinHash::SIGNATURE_SIZE / ROWS;
+
+    std::vector<MinHash::Signature> representatives;
+    std::array<std::unordered_map<uint64_t, std::vector<size_t>>, BANDS> buckets;
+
+    static uint64_t bandKey(const MinHash::Signature& signature, size_t band) {
+        uint64_t key = 0;
+        for (size_t row = 0; row < ROWS; ++row) key = (key << 16) | signature[band * ROWS + row];
+        return key;
+    }
+};
+
+#endif // MIN_HASH_H
@@ -0,0 +1,39 @@
+#ifndef REPOSITORY_LOCKS_H
+#define REPOSITORY_LOCKS_H
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+// Process-wide reader/writer lock per repository checkout. Operations that
+// modify a working tree (clone, pull, checkout) take it exclusively; scans
+// that read the tree take it shared, so a pull never runs under a scan.
+// Updates to a repository's stored summary are serialized separately by
+// summaryWriter, since scans and rescans all hold the tree lock shared.
+class RepositoryLocks {
+public:
+    static std::shared_mutex& forRepo(const std::string& repo_id) {
+        static std::mutex table_mutex;
+        static std::map<std::string, std::unique_ptr<std::shared_mutex>> table;
+
+        std::lock_guard<std::mutex> lock(table_mutex);
+        auto& entry = table[repo_id];
+        if (!entry) entry = std::make_unique<std::shared_mutex>();
+        return *entry;
+    }
+
+    // Held for the whole read-modify-save of a repository's summary
+    static std::mutex& summaryWriter(const std::string& repo_id) {
+        static std::mutex table_mutex;
+        static std::map<std::string, std::unique_ptr<std::mutex>> table;
+
+        std::lock_guard<std::mutex> lock(table_mutex);
+        auto& entry = table[repo_id];
+        if (!entry) entry = std::make_unique<std::mutex>();
+        return *entry;
+    }
+};
+
+#endif // REPOSITORY_LOCKS_H
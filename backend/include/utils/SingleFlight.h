@@ -0,0 +1,62 @@
+#ifndef SINGLE_FLIGHT_H
+#define SINGLE_FLIGHT_H
+
+#include <map>
+#include <mutex>
+#include <future>
+#include <exception>
+#include <functional>
+
+// Runs at most one operation per key at a time. Callers that arrive while an
+// operation for their key is in flight wait for it and receive its result (or
+// its exception) instead of starting a duplicate. Different keys run in parallel.
+template <typename Key, typename Result>
+class SingleFlight {
+private:
+    std::mutex mutex;
+    std::map<Key, std::shared_future<Result>> in_flight;
+
+public:
+    // Run fn for key, or attach to the call already running for it.
+    // If joined is given, it reports whether this caller attached to another call.
+    Result run(const Key& key, const std::function<Result()>& fn, bool* joined = nullptr) {
+        std::promise<Result> promise;
+        std::shared_future<Result> future;
+        bool leader = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = in_flight.find(key);
+            if (it != in_flight.end()) {
+                future = it->second;
+            } else {
+                future = promise.get_future().share();
+                in_flight.emplace(key, future);
+                leader = true;
+            }
+        }
+
+        if (joined) *joined = !leader;
+
+        if (leader) {
+            try {
+                promise.set_value(fn());
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            in_flight.erase(key);
+        }
+
+        return future.get();
+    }
+
+    // Number of keys with an operation currently running
+    size_t inFlightCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return in_flight.size();
+    }
+};
+
+#endif // SINGLE_FLIGHT_H
@@ -0,0 +1,145 @@
+#ifndef SUMMARY_CACHE_H
+#define SUMMARY_CACHE_H
+
+#include <string>
+#include <map>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+// Process-wide LRU cache of parsed `<repo_id>.json` summaries. Entries are
+// validated against the file's mtime and size on every lookup, so a summary
+// rewritten by any scan is re-read automatically. Callers share one immutable
+// parsed tree instead of re-parsing the file per request.
+class SummaryCache {
+private:
+    struct Entry {
+        std::shared_ptr<const json> data;
+        fs::file_time_type mtime;
+        uintmax_t file_size = 0;
+        std::list<std::string>::iterator lru_position;
+    };
+
+    std::mutex mutex;
+    std::map<std::string, Entry> entries;
+    std::list<std::string> lru;     // most recently used first
+    uintmax_t budget_bytes;
+    uintmax_t used_bytes = 0;       // sum of on-disk sizes of cached summaries
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+
+    SummaryCache() {
+        const char* budget = std::getenv("SUMMARY_CACHE_MB");
+        budget_bytes = static_cast<uintmax_t>(budget ? std::atoll(budget) : 256) * 1024 * 1024;
+    }
+
+    // Drop an entry (caller holds the mutex)
+    void removeEntry(std::map<std::string, Entry>::iterator it) {
+        used_bytes -= it->second.file_size;
+        lru.erase(it->second.lru_position);
+        entries.erase(it);
+    }
+
+    // Insert or replace an entry and evict down to the budget (caller holds the mutex)
+    void insertEntry(const std::string& repo_id, std::shared_ptr<const json> data,
+                     fs::file_time_type mtime, uintmax_t file_size) {
+        auto existing = entries.find(repo_id);
+        if (existing != entries.end()) removeEntry(existing);
+
+        // A single summary larger than the whole budget is served but not kept
+        if (file_size > budget_bytes) return;
+
+        lru.push_front(repo_id);
+        entries[repo_id] = {std::move(data), mtime, file_size, lru.begin()};
+        used_bytes += file_size;
+
+        while (used_bytes > budget_bytes && !lru.empty()) {
+            removeEntry(entries.find(lru.back()));
+            evictions++;
+        }
+    }
+
+public:
+    static SummaryCache& instance() {
+        static SummaryCache cache;
+        return cache;
+    }
+
+    SummaryCache(const SummaryCache&) = delete;
+    SummaryCache& operator=(const SummaryCache&) = delete;
+
+    // Parsed summary for a repository, re-read from disk only if the file changed
+    std::shared_ptr<const json> load(const std::string& repo_id, const std::string& summary_file) {
+        std::error_code ec;
+        auto mtime = fs::last_write_time(summary_file, ec);
+        uintmax_t file_size = ec ? 0 : fs::file_size(summary_file, ec);
+        if (ec) {
+            throw std::runtime_error("Summary not found for repo: " + repo_id);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = entries.find(repo_id);
+            if (it != entries.end() && it->second.mtime == mtime && it->second.file_size == file_size) {
+                lru.splice(lru.begin(), lru, it->second.lru_position);
+                hits++;
+                return it->second.data;
+            }
+            misses++;
+        }
+
+        // Parse outside the lock so lookups for other repositories aren't blocked
+        std::ifstream file(summary_file);
+        auto data = std::make_shared<json>();
+        file >> *data;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        insertEntry(repo_id, data, mtime, file_size);
+        return data;
+    }
+
+    // Seed the cache with results that were just written to summary_file
+    void store(const std::string& repo_id, const std::string& summary_file, const json& data) {
+        std::error_code ec;
+        auto mtime = fs::last_write_time(summary_file, ec);
+        uintmax_t file_size = ec ? 0 : fs::file_size(summary_file, ec);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ec) {
+            auto it = entries.find(repo_id);
+            if (it != entries.end()) removeEntry(it);
+            return;
+        }
+        insertEntry(repo_id, std::make_shared<const json>(data), mtime, file_size);
+    }
+
+    void invalidate(const std::string& repo_id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(repo_id);
+        if (it != entries.end()) removeEntry(it);
+    }
+
+    json getStats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        json stats;
+        stats["entries"] = entries.size();
+        stats["budget_bytes"] = budget_bytes;
+        stats["used_bytes"] = used_bytes;
+        stats["hits"] = hits;
+        stats["misses"] = misses;
+        stats["hit_ratio"] = hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0;
+        stats["evictions"] = evictions;
+        return stats;
+    }
+};
+
+#endif // SUMMARY_CACHE_H
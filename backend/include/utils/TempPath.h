@@ -0,0 +1,20 @@
+#ifndef TEMP_PATH_H
+#define TEMP_PATH_H
+
+#include <string>
+#include <atomic>
+#include <unistd.h>
+
+// Sibling temp file names for write-then-rename. Each call returns a distinct
+// name (process id plus a per-process counter), so concurrent writers of the
+// same file never truncate or rename each other's half-written temp file.
+class TempPath {
+public:
+    static std::string uniqueFor(const std::string& file_path) {
+        static std::atomic<unsigned long> counter{0};
+        return file_path + ".tmp." + std::to_string(::getpid()) + "." +
+               std::to_string(counter.fetch_add(1, std::memory_order_relaxed));
+    }
+};
+
+#endif // TEMP_PATH_H
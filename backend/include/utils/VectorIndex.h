@@ -0,0 +1,359 @@
+#ifndef VECTOR_INDEX_H
+#define VECTOR_INDEX_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <queue>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include "TempPath.h"
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define VECTOR_INDEX_X86_DISPATCH 1
+#endif
+
+// Dot-product kernels for the similarity scan. The AVX2 versions are compiled with
+// target attributes and picked at run time, so the binary needs no -march flags and
+// still runs on CPUs without AVX2.
+namespace vector_kernels {
+
+inline float dotF32Scalar(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+inline int32_t dotI8Scalar(const int8_t* a, const int8_t* b, size_t n) {
+    int32_t sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += static_cast<int32_t>(a[i]) * b[i];
+    return sum;
+}
+
+#ifdef VECTOR_INDEX_X86_DISPATCH
+__attribute__((target("avx2,fma"))) inline float dotF32Avx2(const float* a, const float* b, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_hadd_ps(sum, sum);
+    sum = _mm_hadd_ps(sum, sum);
+    float result = _mm_cvtss_f32(sum);
+    for (; i < n; ++i) result += a[i] * b[i];
+    return result;
+}
+
+// Sign-extends 16 bytes at a time to int16 and multiply-adds pairs into int32 lanes
+__attribute__((target("avx2"))) inline int32_t dotI8Avx2(const int8_t* a, const int8_t* b, size_t n) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_hadd_epi32(sum, sum);
+    sum = _mm_hadd_epi32(sum, sum);
+    int32_t result = _mm_cvtsi128_si32(sum);
+    for (; i < n; ++i) result += static_cast<int32_t>(a[i]) * b[i];
+    return result;
+}
+
+inline bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+}
+#endif
+
+using DotF32 = float (*)(const float*, const float*, size_t);
+using DotI8 = int32_t (*)(const int8_t*, const int8_t*, size_t);
+
+inline DotF32 dotF32() {
+#ifdef VECTOR_INDEX_X86_DISPATCH
+    if (hasAvx2()) return dotF32Avx2;
+#endif
+    return dotF32Scalar;
+}
+
+inline DotI8 dotI8() {
+#ifdef VECTOR_INDEX_X86_DISPATCH
+    if (hasAvx2()) return dotI8Avx2;
+#endif
+    return dotI8Scalar;
+}
+
+inline const char* isa() {
+#ifdef VECTOR_INDEX_X86_DISPATCH
+    if (hasAvx2()) return "avx2";
+#endif
+    return "scalar";
+}
+
+} // namespace vector_kernels
+
+// Embedding vectors of one repository's files, stored row after row in a single
+// contiguous block (`<repo_id>.vec` next to the summary). Rows are L2-normalized,
+// so a dot product is the cosine similarity. Int8 rows keep a per-row scale and
+// are a quarter of the float32 size, which is also the memory a query scans.
+// Each row carries the hash of the text it embeds, so a rescan re-embeds only
+// files whose text changed.
+//
+// File layout (native byte order): "ECHOVEC1", u32 dimension, u32 rows,
+// u32 precision, u32 model length + model, then per row u32 path length + path
+// + 64-char text hash, then all rows (float32 or int8), then int8 row scales.
+class VectorIndex {
+public:
+    enum class Precision : uint32_t { Float32 = 0, Int8 = 1 };
+
+    struct Match {
+        size_t row;
+        float score;
+    };
+
+    VectorIndex() = default;
+    VectorIndex(size_t dimension, Precision precision, std::string model)
+        : dim(dimension), precision_(precision), model_(std::move(model)) {}
+
+    size_t size() const { return paths.size(); }
+    size_t dimension() const { return dim; }
+    Precision precision() const { return precision_; }
+    const std::string& model() const { return model_; }
+    const std::string& path(size_t row) const { return paths[row]; }
+    const std::string& textHash(size_t row) const { return text_hashes[row]; }
+
+    // Row of a path, or -1
+    long find(const std::string& file_path) const {
+        auto it = rows_by_path.find(file_path);
+        return it == rows_by_path.end() ? -1 : static_cast<long>(it->second);
+    }
+
+    static Precision parsePrecision(const std::string& name) {
+        return name == "float32" ? Precision::Float32 : Precision::Int8;
+    }
+
+    static const char* precisionName(Precision precision) {
+        return precision == Precision::Float32 ? "float32" : "int8";
+    }
+
+    // Append a row; the vector is normalized (and quantized for int8) here
+    void add(const std::string& file_path, const std::string& text_hash, const std::vector<float>& vector) {
+        if (vector.size() != dim) {
+            throw std::runtime_error("Embedding has " + std::to_string(vector.size()) +
+                                     " dimensions, index expects " + std::to_string(dim));
+        }
+        std::vector<float> unit = normalized(vector);
+
+        if (precision_ == Precision::Float32) {
+            f32.insert(f32.end(), unit.begin(), unit.end());
+        } else {
+            float max_abs = 0.0f;
+            for (float v : unit) max_abs = std::max(max_abs, std::fabs(v));
+            float scale = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+            for (float v : unit) i8.push_back(static_cast<int8_t>(std::lround(v / scale)));
+            scales.push_back(scale);
+        }
+        addMetadata(file_path, text_hash);
+    }
+
+    // Append a row of another index with the same dimension and precision, as stored
+    void copyRow(const VectorIndex& from, size_t row) {
+        if (from.dim != dim || from.precision_ != precision_) {
+            throw std::runtime_error("Cannot copy rows between incompatible vector indexes");
+        }
+        if (precision_ == Precision::Float32) {
+            f32.insert(f32.end(), from.f32.begin() + row * dim, from.f32.begin() + (row + 1) * dim);
+        } else {
+            i8.insert(i8.end(), from.i8.begin() + row * dim, from.i8.begin() + (row + 1) * dim);
+            scales.push_back(from.scales[row]);
+        }
+        addMetadata(from.paths[row], from.text_hashes[row]);
+    }
+
+    // The k rows most similar to the query, best first
+    std::vector<Match> search(const std::vector<float>& query, size_t k) const {
+        if (query.size() != dim) {
+            throw std::runtime_error("Query has " + std::to_string(query.size()) +
+                                     " dimensions, index has " + std::to_string(dim));
+        }
+        std::vector<float> unit = normalized(query);
+
+        // Min-heap of the best k so far: the worst kept match is on top
+        auto worse = [](const Match& a, const Match& b) { return a.score > b.score; };
+        std::priority_queue<Match, std::vector<Match>, decltype(worse)> best(worse);
+        auto offer = [&](size_t row, float score) {
+            if (best.size() < k) {
+                best.push({row, score});
+            } else if (k > 0 && score > best.top().score) {
+                best.pop();
+                best.push({row, score});
+            }
+        };
+
+        if (precision_ == Precision::Float32) {
+            auto dot = vector_kernels::dotF32();
+            for (size_t row = 0; row < size(); ++row) {
+                offer(row, dot(f32.data() + row * dim, unit.data(), dim));
+            }
+        } else {
+            // Quantize the query the same way; its scale is shared by every row and only
+            // needed to report cosine-scale scores
+            float max_abs = 0.0f;
+            for (float v : unit) max_abs = std::max(max_abs, std::fabs(v));
+            float query_scale = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+            std::vector<int8_t> quantized(dim);
+            for (size_t i = 0; i < dim; ++i) quantized[i] = static_cast<int8_t>(std::lround(unit[i] / query_scale));
+
+            auto dot = vector_kernels::dotI8();
+            for (size_t row = 0; row < size(); ++row) {
+                offer(row, static_cast<float>(dot(i8.data() + row * dim, quantized.data(), dim)) *
+                               scales[row] * query_scale);
+            }
+        }
+
+        std::vector<Match> matches;
+        while (!best.empty()) {
+            matches.push_back(best.top());
+            best.pop();
+        }
+        std::reverse(matches.begin(), matches.end());
+        return matches;
+    }
+
+    void save(const std::string& file_path) const {
+        std::string tmp_path = TempPath::uniqueFor(file_path);
+        std::ofstream out(tmp_path, std::ios::binary);
+        if (!out) throw std::runtime_error("Cannot write vector index: " + file_path);
+
+        out.write(MAGIC, 8);
+        writeU32(out, static_cast<uint32_t>(dim));
+        writeU32(out, static_cast<uint32_t>(size()));
+        writeU32(out, static_cast<uint32_t>(precision_));
+        writeString(out, model_);
+        for (size_t row = 0; row < size(); ++row) {
+            writeString(out, paths[row]);
+            out.write(text_hashes[row].data(), HASH_LENGTH);
+        }
+        if (precision_ == Precision::Float32) {
+            out.write(reinterpret_cast<const char*>(f32.data()), f32.size() * sizeof(float));
+        } else {
+            out.write(reinterpret_cast<const char*>(i8.data()), i8.size());
+            out.write(reinterpret_cast<const char*>(scales.data()), scales.size() * sizeof(float));
+        }
+        out.close();
+        if (!out) {
+            std::remove(tmp_path.c_str());
+            throw std::runtime_error("Failed writing vector index: " + file_path);
+        }
+        std::rename(tmp_path.c_str(), file_path.c_str());
+    }
+
+    static VectorIndex load(const std::string& file_path) {
+        std::ifstream in(file_path, std::ios::binary);
+        if (!in) throw std::runtime_error("Cannot open vector index: " + file_path);
+
+        char magic[8];
+        in.read(magic, 8);
+        if (!in || std::memcmp(magic, MAGIC, 8) != 0) {
+            throw std::runtime_error("Not a vector index: " + file_path);
+        }
+
+        VectorIndex index;
+        index.dim = readU32(in);
+        uint32_t rows = readU32(in);
+        index.precision_ = static_cast<Precision>(readU32(in));
+        index.model_ = readString(in);
+        for (uint32_t row = 0; row < rows; ++row) {
+            std::string file = readString(in);
+            std::string hash(HASH_LENGTH, '\0');
+            in.read(&hash[0], HASH_LENGTH);
+            index.addMetadata(file, hash);
+        }
+
+        size_t values = static_cast<size_t>(rows) * index.dim;
+        if (index.precision_ == Precision::Float32) {
+            index.f32.resize(values);
+            in.read(reinterpret_cast<char*>(index.f32.data()), values * sizeof(float));
+        } else {
+            index.i8.resize(values);
+            index.scales.resize(rows);
+            in.read(reinterpret_cast<char*>(index.i8.data()), values);
+            in.read(reinterpret_cast<char*>(index.scales.data()), rows * sizeof(float));
+        }
+        if (!in) throw std::runtime_error("Truncated vector index: " + file_path);
+        return index;
+    }
+
+private:
+    static constexpr const char* MAGIC = "ECHOVEC1";
+    static constexpr size_t HASH_LENGTH = 64;   // hex SHA-256
+
+    size_t dim = 0;
+    Precision precision_ = Precision::Int8;
+    std::string model_;
+    std::vector<std::string> paths;
+    std::vector<std::string> text_hashes;
+    std::map<std::string, size_t> rows_by_path;
+    std::vector<float> f32;         // rows * dim, float32 precision
+    std::vector<int8_t> i8;         // rows * dim, int8 precision
+    std::vector<float> scales;      // per row, int8 precision
+
+    void addMetadata(const std::string& file_path, const std::string& text_hash) {
+        if (text_hash.size() != HASH_LENGTH) {
+            throw std::runtime_error("Vector index text hashes must be hex SHA-256");
+        }
+        rows_by_path[file_path] = paths.size();
+        paths.push_back(file_path);
+        text_hashes.push_back(text_hash);
+    }
+
+    static std::vector<float> normalized(const std::vector<float>& vector) {
+        double norm = 0.0;
+        for (float v : vector) norm += static_cast<double>(v) * v;
+        norm = std::sqrt(norm);
+        std::vector<float> unit(vector);
+        if (norm > 0.0) {
+            for (float& v : unit) v = static_cast<float>(v / norm);
+        }
+        return unit;
+    }
+
+    static void writeU32(std::ofstream& out, uint32_t value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    static void writeString(std::ofstream& out, const std::string& value) {
+        writeU32(out, static_cast<uint32_t>(value.size()));
+        out.write(value.data(), value.size());
+    }
+
+    static uint32_t readU32(std::ifstream& in) {
+        uint32_t value = 0;
+        in.read(reinterpret_cast<char*>(&value), sizeof(value));
+        if (!in) throw std::runtime_error("Truncated vector index");
+        return value;
+    }
+
+    static std::string readString(std::ifstream& in) {
+        uint32_t length = readU32(in);
+        std::string value(length, '\0');
+        in.read(&value[0], length);
+        if (!in) throw std::runtime_error("Truncated vector index");
+        return value;
+    }
+};
+
+#endif // VECTOR_INDEX_H
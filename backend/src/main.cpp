@@ -3,9 +3,18 @@
 #include <memory>
 #include <chrono>
 #include <ctime>
+#include <csignal>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
 #include "services/GitHubService.h"
 #include "services/ScannerService.h"
 #include "services/DocumentationService.h"
+#include "services/DocumentationJobQueue.h"
+#include "services/WatchService.h"
+#include "services/FetchScheduler.h"
+#include "services/RepositoryStore.h"
 
 // Logging helper function
 void logRequest(const std::string& method, const std::string& path) {
@@ -23,6 +32,29 @@ void logError(const std::string& context, const std::exception& e) {
               << "] " << context << ": " << e.what() << std::endl;
 }
 
+// One WebSocket client of /api/docs/generate/stream. The generation thread sends
+// through it; onclose clears the connection and cancels the generation.
+struct DocStreamSession {
+    std::mutex mutex;
+    crow::websocket::connection* conn;
+    std::atomic<bool> cancelled{false};
+    bool running = false;
+
+    explicit DocStreamSession(crow::websocket::connection* c) : conn(c) {}
+
+    bool send(const json& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!conn) return false;
+        conn->send_text(message.dump());
+        return true;
+    }
+
+    void close(const std::string& reason) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (conn) conn->close(reason);
+    }
+};
+
 // Custom middleware for CORS
 struct CORSHandler {
     struct context {};
@@ -50,6 +82,9 @@ struct CORSHandler {
 };
 
 int main() {
+    // A child process (git cat-file) exiting early must not kill the server on write
+    std::signal(SIGPIPE, SIG_IGN);
+    
     try {
         // Use App with middleware
         crow::App<CORSHandler> app;
@@ -63,11 +98,38 @@ int main() {
         std::shared_ptr<GitHubService> github_service;
         std::shared_ptr<ScannerService> scanner_service;
         std::shared_ptr<DocumentationService> doc_service;
+        std::shared_ptr<DocumentationJobQueue> doc_jobs;
+        std::shared_ptr<WatchService> watch_service;
+        std::shared_ptr<FetchScheduler> fetch_scheduler;
+        std::shared_ptr<RepositoryStore> repository_store;
         
         try {
             github_service = std::make_shared<GitHubService>();
             scanner_service = std::make_shared<ScannerService>();
             doc_service = std::make_shared<DocumentationService>();
+            doc_jobs = std::make_shared<DocumentationJobQueue>(doc_service);
+            watch_service = std::make_shared<WatchService>(
+                [scanner_service](const std::string& repo_id,
+                                  const std::string& root_path,
+                                  const std::vector<std::string>& changed_paths,
+                                  bool full_rescan) {
+                    if (full_rescan) {
+                        scanner_service->scanRepository(root_path, repo_id);
+                    } else {
+                        scanner_service->rescanFiles(repo_id, root_path, changed_paths);
+                    }
+                });
+            fetch_scheduler = std::make_shared<FetchScheduler>(github_service);
+            
+            // Checkout quota: evicted working trees are re-cloned through the scheduler on next use
+            repository_store = std::make_shared<RepositoryStore>();
+            repository_store->setMaterializer(
+                [fetch_scheduler](const std::string& url, const std::string& branch, const std::string& checkout_mode) {
+                    return fetch_scheduler->submitClone(url, branch, checkout_mode).get();
+                });
+            github_service->setRepositoryStore(repository_store);
+            scanner_service->setRepositoryStore(repository_store);
+            scanner_service->setEmbeddingService(doc_service->getEmbeddingService());
             std::cout << "✅ All services initialized successfully" << std::endl;
         } catch (const std::exception& e) {
             std::cerr << "❌ Failed to initialize services: " << e.what() << std::endl;
@@ -83,23 +145,44 @@ int main() {
             response["version"] = "0.1.0";
             response["status"] = "running";
             response["endpoints"] = crow::json::wvalue::object();
-            response["endpoints"]["/api/health"] = "Health check endpoint";
+            response["endpoints"]["/api/health"] = "Health check endpoint, with each Ollama backend's cached availability, load and speed";
             response["endpoints"]["/api/system/info"] = "Get system specs and selected model";
             response["endpoints"]["/api/repos/add"] = "Add new repository (POST)";
+            response["endpoints"]["/api/repos/add-local"] = "Add a locally mounted repository under LOCAL_REPO_ROOTS, optionally watched (POST)";
+            response["endpoints"]["/api/repos/upload?name=<name>"] = "Upload a .tar.gz/.tar/.zip archive as request body (POST)";
+            response["endpoints"]["/api/repos/watches"] = "List watched local repositories";
+            response["endpoints"]["/api/repos/<id>/watch"] = "Stop watching a local repository (DELETE)";
+            response["endpoints"]["/api/fetch/queue"] = "Running and queued clone/fetch jobs";
+            response["endpoints"]["/api/repos/<id>/rescan"] = "Rescan a cloned repository (POST)";
+            response["endpoints"]["/api/store/stats"] = "Checkout disk usage, quota and evictions";
+            response["endpoints"]["/api/cache/summaries"] = "Parsed summary cache hit ratio and size";
             response["endpoints"]["/api/repos"] = "List all repositories";
-            response["endpoints"]["/api/repos/<id>/summary"] = "Get repository summary";
-            response["endpoints"]["/api/docs/generate"] = "Generate documentation (POST)";
+            response["endpoints"]["/api/repos/<id>/summary"] = "Get repository summary (near-duplicate files collapsed; ?include_duplicates=true lists all)";
+            response["endpoints"]["/api/docs/generate"] = "Generate documentation (POST, mode=single|map_reduce|auto|sections, force=true bypasses the cache)";
+            response["endpoints"]["/api/docs/jobs"] = "Queue documentation generation (POST, returns a job id) or list queued/running jobs (GET)";
+            response["endpoints"]["/api/docs/jobs/<id>"] = "Job status and result (GET, ?wait=N long-polls up to N seconds) or cancel (DELETE)";
+            response["endpoints"]["/api/docs/generate/stream"] = "Stream documentation tokens as they are generated (WebSocket; send the /api/docs/generate body)";
+            response["endpoints"]["/api/docs/generate-batch"] = "Queue several doc types over one shared repository context as one job (POST, returns a job id)";
+            response["endpoints"]["/api/docs/cache/stats"] = "Generated documentation cache hit ratio and size";
+            response["endpoints"]["/api/repos/<id>/docs/manifest?doc_type=<type>&audience=<audience>"] = "Files behind each section of the last sectioned document and which sections were regenerated";
             return response;
         });
         
         // Health check endpoint
         CROW_ROUTE(app, "/api/health")
-        ([](){
+        ([&doc_service](){
             logRequest("GET", "/api/health");
-            crow::json::wvalue response;
+            nlohmann::json response;
             response["status"] = "healthy";
             response["timestamp"] = std::chrono::system_clock::now().time_since_epoch().count();
-            return response;
+            // Cached circuit breaker state; this endpoint never waits on Ollama
+            if (auto llm_service = doc_service->getLLMService()) {
+                response["llm"] = llm_service->getHealth();
+            }
+
+            crow::response res(200, response.dump());
+            res.add_header("Content-Type", "application/json");
+            return res;
         });
 
         // System info endpoint - shows detected system specs and selected model
@@ -171,7 +254,7 @@ int main() {
 
         // Add repository endpoint
         CROW_ROUTE(app, "/api/repos/add").methods(crow::HTTPMethod::Post)
-        ([&github_service, &scanner_service](const crow::request& req){
+        ([&fetch_scheduler, &scanner_service](const crow::request& req){
             logRequest("POST", "/api/repos/add");
             
             try {
@@ -202,12 +285,36 @@ int main() {
                     branch = "main";
                 }
                 
+                // Optional checkout mode: "full" or "sparse" (analyzable files only)
+                std::string checkout_mode;
+                if (body.has("checkout_mode")) {
+                    checkout_mode = body["checkout_mode"].s();
+                    if (!GitHubService::isValidCheckoutMode(checkout_mode)) {
+                        crow::json::wvalue error;
+                        error["error"] = "Invalid checkout mode";
+                        error["details"] = "checkout_mode must be 'full', 'sparse' or 'bare'";
+                        return crow::response(400, error);
+                    }
+                }
+                
+                // Optional historical commit, scanned from the object database without checkout
+                std::string commit;
+                if (body.has("commit")) {
+                    commit = body["commit"].s();
+                    if (checkout_mode != "bare") {
+                        crow::json::wvalue error;
+                        error["error"] = "Invalid checkout mode";
+                        error["details"] = "commit requires checkout_mode 'bare'";
+                        return crow::response(400, error);
+                    }
+                }
+                
                 std::cout << "📦 Processing repository: " << github_url << " (branch: " << branch << ")" << std::endl;
                 
-                // Clone repository
+                // Clone repository (queued behind the bounded fetch scheduler)
                 std::map<std::string, std::string> repo_data;
                 try {
-                    repo_data = github_service->cloneRepository(github_url, branch);
+                    repo_data = fetch_scheduler->submitClone(github_url, branch, checkout_mode, commit).get();
                 } catch (const std::exception& e) {
                     logError("Repository cloning", e);
                     crow::json::wvalue error;
@@ -219,7 +326,12 @@ int main() {
                 // Scan repository
                 nlohmann::json scan_results;
                 try {
-                    scan_results = scanner_service->scanRepository(repo_data["local_path"]);
+                    if (repo_data["checkout_mode"] == "bare") {
+                        scan_results = scanner_service->scanCommit(
+                            repo_data["mirror_path"], repo_data["commit"], repo_data["repo_id"]);
+                    } else {
+                        scan_results = scanner_service->scanRepository(repo_data["local_path"]);
+                    }
                 } catch (const std::exception& e) {
                     logError("Repository scanning", e);
                     crow::json::wvalue error;
@@ -232,10 +344,20 @@ int main() {
                 crow::json::wvalue response;
                 response["status"] = "success";
                 response["repo_id"] = repo_data["repo_id"];
+                response["branch"] = repo_data["branch"];
                 response["files_scanned"] = scan_results["total_files"].get<int>();
                 response["analyzed_files"] = scan_results["analyzed_files"].get<int>();
                 response["message"] = "Repository indexed successfully";
                 
+                // Mirror cache timings (absent for legacy full clones)
+                if (repo_data.count("fetch_ms")) {
+                    response["clone"]["mirror_hit"] = repo_data["mirror_hit"] == "true";
+                    response["clone"]["fetch_ms"] = std::stoll(repo_data["fetch_ms"]);
+                    response["clone"]["checkout_ms"] = std::stoll(repo_data["checkout_ms"]);
+                    response["clone"]["commit"] = repo_data["commit"];
+                    response["clone"]["checkout_mode"] = repo_data["checkout_mode"];
+                }
+                
                 std::cout << "✅ Successfully indexed repository: " << repo_data["repo_id"] << std::endl;
                 return crow::response(200, response);
                 
@@ -248,9 +370,307 @@ int main() {
             }
         });
         
+        // Add locally mounted repository endpoint (no clone)
+        CROW_ROUTE(app, "/api/repos/add-local").methods(crow::HTTPMethod::Post)
+        ([&github_service, &scanner_service, &watch_service](const crow::request& req){
+            logRequest("POST", "/api/repos/add-local");
+
+            // Without configured roots a client could index any directory the server can read
+            if (!github_service->localRepositoriesEnabled()) {
+                crow::json::wvalue error;
+                error["error"] = "Local repositories are disabled";
+                error["details"] = "Set LOCAL_REPO_ROOTS to the directories local repositories may be added from";
+                return crow::response(403, error);
+            }
+            
+            try {
+                // Parse JSON body
+                auto body = crow::json::load(req.body);
+                if (!body) {
+                    std::cerr << "❌ Invalid JSON received" << std::endl;
+                    crow::json::wvalue error;
+                    error["error"] = "Invalid JSON format";
+                    error["details"] = "Request body must be valid JSON";
+                    return crow::response(400, error);
+                }
+                
+                // Validate required fields
+                if (!body.has("local_path")) {
+                    crow::json::wvalue error;
+                    error["error"] = "Missing required field";
+                    error["details"] = "local_path is required";
+                    return crow::response(400, error);
+                }
+                
+                std::string local_path = body["local_path"].s();
+                bool watch = body.has("watch") && body["watch"].b();
+                
+                std::cout << "📦 Processing local repository: " << local_path
+                          << (watch ? " (watch mode)" : "") << std::endl;
+                
+                // Register local path
+                std::map<std::string, std::string> repo_data;
+                try {
+                    repo_data = github_service->registerLocalRepository(local_path);
+                } catch (const std::exception& e) {
+                    logError("Local repository registration", e);
+                    crow::json::wvalue error;
+                    error["error"] = "Invalid local repository";
+                    error["details"] = e.what();
+                    return crow::response(400, error);
+                }
+                
+                // Full scan once, then keep it fresh incrementally
+                nlohmann::json scan_results;
+                try {
+                    scan_results = scanner_service->scanRepository(repo_data["local_path"], repo_data["repo_id"]);
+                    if (watch) {
+                        watch_service->watch(repo_data["repo_id"], repo_data["local_path"]);
+                    }
+                } catch (const std::exception& e) {
+                    logError("Local repository scanning", e);
+                    crow::json::wvalue error;
+                    error["error"] = "Failed to scan repository";
+                    error["details"] = e.what();
+                    return crow::response(500, error);
+                }
+                
+                crow::json::wvalue response;
+                response["status"] = "success";
+                response["repo_id"] = repo_data["repo_id"];
+                response["local_path"] = repo_data["local_path"];
+                response["watching"] = watch;
+                response["files_scanned"] = scan_results["total_files"].get<int>();
+                response["analyzed_files"] = scan_results["analyzed_files"].get<int>();
+                response["message"] = "Local repository indexed successfully";
+                
+                std::cout << "✅ Successfully indexed local repository: " << repo_data["repo_id"] << std::endl;
+                return crow::response(200, response);
+                
+            } catch (const std::exception& e) {
+                logError("Add local repository endpoint", e);
+                crow::json::wvalue error;
+                error["error"] = "Internal server error";
+                error["details"] = e.what();
+                return crow::response(500, error);
+            }
+        });
+        
+        // Upload archive endpoint - raw .tar.gz/.tar/.zip body, scanned in memory
+        CROW_ROUTE(app, "/api/repos/upload").methods(crow::HTTPMethod::Post)
+        ([&github_service, &scanner_service](const crow::request& req){
+            logRequest("POST", "/api/repos/upload");
+            
+            try {
+                const char* name_param = req.url_params.get("name");
+                if (!name_param || std::string(name_param).empty()) {
+                    crow::json::wvalue error;
+                    error["error"] = "Missing required parameter";
+                    error["details"] = "name query parameter is required (e.g. /api/repos/upload?name=my-project)";
+                    return crow::response(400, error);
+                }
+                std::string name = name_param;
+                
+                if (ArchiveReader::detectFormat(req.body).empty()) {
+                    crow::json::wvalue error;
+                    error["error"] = "Unsupported archive format";
+                    error["details"] = "Request body must be a .tar.gz, .tar or .zip archive";
+                    return crow::response(400, error);
+                }
+                
+                std::cout << "📦 Processing uploaded archive: " << name << " ("
+                          << req.body.size() / 1024 << " KB)" << std::endl;
+                
+                std::string repo_id = github_service->generateUploadId(name);
+                nlohmann::json scan_results;
+                try {
+                    scan_results = scanner_service->scanArchive(req.body, name, repo_id);
+                } catch (const std::exception& e) {
+                    logError("Archive scanning", e);
+                    crow::json::wvalue error;
+                    error["error"] = "Failed to read archive";
+                    error["details"] = e.what();
+                    return crow::response(400, error);
+                }
+                
+                crow::json::wvalue response;
+                response["status"] = "success";
+                response["repo_id"] = repo_id;
+                response["name"] = name;
+                response["archive_format"] = scan_results["archive_format"].get<std::string>();
+                response["archive_entries"] = scan_results["archive_entries"].get<long long>();
+                response["files_scanned"] = scan_results["total_files"].get<int>();
+                response["analyzed_files"] = scan_results["analyzed_files"].get<int>();
+                response["skipped_large_files"] = scan_results["skipped_large_files"].get<long long>();
+                response["message"] = "Archive indexed successfully";
+                
+                std::cout << "✅ Successfully indexed archive: " << repo_id << std::endl;
+                return crow::response(200, response);
+                
+            } catch (const std::exception& e) {
+                logError("Upload repository endpoint", e);
+                crow::json::wvalue error;
+                error["error"] = "Internal server error";
+                error["details"] = e.what();
+                return crow::response(500, error);
+            }
+        });
+        
+        // List watched repositories endpoint
+        CROW_ROUTE(app, "/api/repos/watches")
+        ([&watch_service](){
+            logRequest("GET", "/api/repos/watches");
+            
+            auto watches = watch_service->listWatches();
+            nlohmann::json response;
+            response["status"] = "success";
+            response["watches"] = watches;
+            response["count"] = watches.size();
+            
+            crow::response res(200, response.dump());
+            res.add_header("Content-Type", "application/json");
+            return res;
+        });
+        
+        // Stop watching a repository endpoint
+        CROW_ROUTE(app, "/api/repos/<string>/watch").methods(crow::HTTPMethod::Delete)
+        ([&watch_service](const std::string& repo_id){
+            logRequest("DELETE", "/api/repos/" + repo_id + "/watch");
+            
+            if (!watch_service->unwatch(repo_id)) {
+                crow::json::wvalue error;
+                error["error"] = "Repository is not being watched";
+                error["repo_id"] = repo_id;
+                return crow::response(404, error);
+            }
+            
+            crow::json::wvalue response;
+            response["status"] = "success";
+            response["repo_id"] = repo_id;
+            response["message"] = "Stopped watching repository";
+            return crow::response(200, response);
+        });
+        
+        // Fetch queue endpoint - running and queued clones/refreshes
+        CROW_ROUTE(app, "/api/fetch/queue")
+        ([&fetch_scheduler](){
+            logRequest("GET", "/api/fetch/queue");
+            
+            nlohmann::json response = fetch_scheduler->getStatus();
+            response["status"] = "success";
+            
+            crow::response res(200, response.dump());
+            res.add_header("Content-Type", "application/json");
+            return res;
+        });
+        
+        // Rescan a cloned repository, re-materializing its checkout if it was evicted
+        CROW_ROUTE(app, "/api/repos/<string>/rescan").methods(crow::HTTPMethod::Post)
+        ([&repository_store, &scanner_service](const std::string& repo_id){
+            logRequest("POST", "/api/repos/" + repo_id + "/rescan");
+            
+            try {
+                std::string local_path = repository_store->ensureMaterialized(repo_id);
+                if (local_path.empty()) {
+                    crow::json::wvalue error;
+                    error["error"] = "Repository checkout not found";
+                    error["details"] = "Only repositories added via /api/repos/add can be rescanned";
+                    error["repo_id"] = repo_id;
+                    return crow::response(404, error);
+                }
+                
+                auto scan_results = scanner_service->scanRepository(local_path, repo_id);
+                
+                crow::json::wvalue response;
+                response["status"] = "success";
+                response["repo_id"] = repo_id;
+                response["files_scanned"] = scan_results["total_files"].get<int>();
+                response["analyzed_files"] = scan_results["analyzed_files"].get<int>();
+                response["message"] = "Repository rescanned successfully";
+                return crow::response(200, response);
+                
+            } catch (const std::exception& e) {
+                logError("Rescan repository", e);
+                crow::json::wvalue error;
+                error["error"] = "Failed to rescan repository";
+                error["details"] = e.what();
+                return crow::response(500, error);
+            }
+        });
+        
+        // Repository store endpoint - checkout disk usage and evictions
+        CROW_ROUTE(app, "/api/store/stats")
+        ([&repository_store](){
+            logRequest("GET", "/api/store/stats");
+            
+            nlohmann::json response = repository_store->getStats();
+            response["status"] = "success";
+            
+            crow::response res(200, response.dump());
+            res.add_header("Content-Type", "application/json");
+            return res;
+        });
+        
+        // Summary cache endpoint - parsed summary hit ratio and memory use
+        CROW_ROUTE(app, "/api/cache/summaries")
+        ([](){
+            logRequest("GET", "/api/cache/summaries");
+            
+            nlohmann::json response = SummaryCache::instance().getStats();
+            response["status"] = "success";
+            
+            crow::response res(200, response.dump());
+            res.add_header("Content-Type", "application/json");
+            return res;
+        });
+        
+        // Documentation cache endpoint - hit ratio and bytes stored
+        CROW_ROUTE(app, "/api/docs/cache/stats")
+        ([&doc_service](){
+            logRequest("GET", "/api/docs/cache/stats");
+            
+            nlohmann::json response = doc_service->getCacheStats();
+            response["status"] = "success";
+            
+            crow::response res(200, response.dump());
+            res.add_header("Content-Type", "application/json");
+            return res;
+        });
+        
+        // Section manifest endpoint - inputs of each section of a generated document
+        CROW_ROUTE(app, "/api/repos/<string>/docs/manifest")
+        ([&doc_service](const crow::request& req, const std::string& repo_id){
+            logRequest("GET", "/api/repos/" + repo_id + "/docs/manifest");
+            
+            const char* doc_type = req.url_params.get("doc_type");
+            const char* audience = req.url_params.get("audience");
+            if (!doc_type) {
+                crow::json::wvalue error;
+                error["error"] = "Missing required field";
+                error["details"] = "doc_type query parameter is required";
+                return crow::response(400, error);
+            }
+            
+            try {
+                nlohmann::json manifest = doc_service->getSectionManifest(repo_id, doc_type,
+                                                                          audience ? audience : "developers");
+                crow::response res(200, manifest.dump());
+                res.add_header("Content-Type", "application/json");
+                return res;
+                
+            } catch (const std::exception& e) {
+                logError("Get section manifest", e);
+                crow::json::wvalue error;
+                error["error"] = "Manifest not found";
+                error["details"] = e.what();
+                error["repo_id"] = repo_id;
+                return crow::response(404, error);
+            }
+        });
+        
         // Get repository summary endpoint
         CROW_ROUTE(app, "/api/repos/<string>/summary")
-        ([&scanner_service](const std::string& repo_id){
+        ([&scanner_service](const crow::request& req, const std::string& repo_id){
             logRequest("GET", "/api/repos/" + repo_id + "/summary");
             
             try {
@@ -258,7 +678,12 @@ int main() {
                 
                 auto summary = scanner_service->getRepositorySummary(repo_id);
                 
-                crow::response res(200, summary.dump());
+                // Near-duplicate files are folded into their representative unless asked for
+                const char* include_duplicates = req.url_params.get("include_duplicates");
+                bool collapse = !include_duplicates || std::string(include_duplicates) != "true";
+                
+                crow::response res(200, collapse ? ScannerService::collapseNearDuplicates(*summary).dump()
+                                                 : summary->dump());
                 res.add_header("Content-Type", "application/json");
                 return res;
                 
@@ -338,13 +763,17 @@ int main() {
                 } else {
                     audience = "developers";
                 }
+                bool force = body.has("force") && body["force"].b();
+                std::string mode = body.has("mode") ? std::string(body["mode"].s()) : "";
+                if (!mode.empty() && !DocumentationService::isValidGenerationMode(mode)) {
+                    crow::json::wvalue error;
+                    error["error"] = "Invalid generation mode";
+                    error["details"] = "mode must be 'single', 'map_reduce', 'auto' or 'sections'";
+                    return crow::response(400, error);
+                }
                 
                 // Validate doc_type - accept detailed types (internal_*, external_*) or legacy (internal, external)
-                bool valid_type = (doc_type == "internal" || doc_type == "external" ||
-                                   doc_type.rfind("internal_", 0) == 0 ||
-                                   doc_type.rfind("external_", 0) == 0);
-
-                if (!valid_type) {
+                if (!DocumentationService::isValidDocType(doc_type)) {
                     crow::json::wvalue error;
                     error["error"] = "Invalid documentation type";
                     error["details"] = "doc_type must start with 'internal_' or 'external_' (e.g., 'internal_api', 'external_user_manual')";
@@ -356,8 +785,9 @@ int main() {
                 
                 // Generate documentation
                 std::string documentation;
+                bool from_cache = false;
                 try {
-                    documentation = doc_service->generateDocumentation(repo_id, doc_type, audience);
+                    documentation = doc_service->generateDocumentation(repo_id, doc_type, audience, mode, force, &from_cache);
                 } catch (const std::exception& e) {
                     logError("Documentation generation", e);
                     crow::json::wvalue error;
@@ -374,6 +804,7 @@ int main() {
                 response["repo_id"] = repo_id;
                 response["doc_type"] = doc_type;
                 response["audience"] = audience;
+                response["cached"] = from_cache;
                 
                 std::cout << "✅ Successfully generated " << doc_type << " documentation" << std::endl;
                 return crow::response(200, response);
@@ -387,6 +818,324 @@ int main() {
             }
         });
         
+        // Batch documentation generation - one repository context, several doc types/audiences.
+        // The batch runs as one job on the job queue's workers; collect it from /api/docs/jobs/<id>
+        CROW_ROUTE(app, "/api/docs/generate-batch").methods(crow::HTTPMethod::Post)
+        ([&doc_jobs](const crow::request& req){
+            logRequest("POST", "/api/docs/generate-batch");
+
+            try {
+                auto body = crow::json::load(req.body);
+                if (!body) {
+                    crow::json::wvalue error;
+                    error["error"] = "Invalid JSON format";
+                    error["details"] = "Request body must be valid JSON";
+                    return crow::response(400, error);
+                }
+
+                if (!body.has("repo_id") || (!body.has("items") && !body.has("doc_types"))) {
+                    crow::json::wvalue error;
+                    error["error"] = "Missing required fields";
+                    error["details"] = "repo_id and either items or doc_types are required";
+                    return crow::response(400, error);
+                }
+
+                std::string repo_id = body["repo_id"].s();
+                std::string default_audience = body.has("audience") ? std::string(body["audience"].s()) : "developers";
+                bool force = body.has("force") && body["force"].b();
+
+                // items: [{doc_type, audience?}], or doc_types: [...] sharing one audience
+                std::vector<std::pair<std::string, std::string>> items;
+                if (body.has("items")) {
+                    for (const auto& item : body["items"]) {
+                        if (!item.has("doc_type")) {
+                            crow::json::wvalue error;
+                            error["error"] = "Missing required fields";
+                            error["details"] = "every item needs a doc_type";
+                            return crow::response(400, error);
+                        }
+                        items.push_back({item["doc_type"].s(),
+                                         item.has("audience") ? std::string(item["audience"].s()) : default_audience});
+                    }
+                } else {
+                    for (const auto& doc_type : body["doc_types"]) {
+                        items.push_back({doc_type.s(), default_audience});
+                    }
+                }
+
+                if (items.empty()) {
+                    crow::json::wvalue error;
+                    error["error"] = "Empty batch";
+                    error["details"] = "at least one doc_type is required";
+                    return crow::response(400, error);
+                }
+
+                for (const auto& [doc_type, audience] : items) {
+                    if (!DocumentationService::isValidDocType(doc_type)) {
+                        crow::json::wvalue error;
+                        error["error"] = "Invalid documentation type";
+                        error["details"] = "doc_type '" + doc_type + "' must start with 'internal_' or 'external_'";
+                        return crow::response(400, error);
+                    }
+                }
+
+                nlohmann::json job;
+                try {
+                    job = doc_jobs->submitBatch(repo_id, items, force);
+                } catch (const std::exception& e) {
+                    crow::json::wvalue error;
+                    error["error"] = "Queue full";
+                    error["details"] = e.what();
+                    return crow::response(503, error);
+                }
+
+                job["status"] = "success";
+                crow::response res(202, job.dump());
+                res.add_header("Content-Type", "application/json");
+                return res;
+
+            } catch (const std::exception& e) {
+                logError("Generate batch endpoint", e);
+                crow::json::wvalue error;
+                error["error"] = "Internal server error";
+                error["details"] = e.what();
+                return crow::response(500, error);
+            }
+        });
+
+        // Documentation jobs - generation runs on the job queue's own workers instead of a request thread
+        CROW_ROUTE(app, "/api/docs/jobs").methods(crow::HTTPMethod::Post)
+        ([&doc_jobs](const crow::request& req){
+            logRequest("POST", "/api/docs/jobs");
+
+            try {
+                auto body = crow::json::load(req.body);
+                if (!body) {
+                    crow::json::wvalue error;
+                    error["error"] = "Invalid JSON format";
+                    error["details"] = "Request body must be valid JSON";
+                    return crow::response(400, error);
+                }
+
+                if (!body.has("repo_id") || !body.has("doc_type")) {
+                    crow::json::wvalue error;
+                    error["error"] = "Missing required fields";
+                    error["details"] = "repo_id and doc_type are required";
+                    return crow::response(400, error);
+                }
+
+                std::string repo_id = body["repo_id"].s();
+                std::string doc_type = body["doc_type"].s();
+                std::string audience = body.has("audience") ? std::string(body["audience"].s()) : "developers";
+                bool force = body.has("force") && body["force"].b();
+                std::string mode = body.has("mode") ? std::string(body["mode"].s()) : "";
+                if (!mode.empty() && !DocumentationService::isValidGenerationMode(mode)) {
+                    crow::json::wvalue error;
+                    error["error"] = "Invalid generation mode";
+                    error["details"] = "mode must be 'single', 'map_reduce', 'auto' or 'sections'";
+                    return crow::response(400, error);
+                }
+                if (!DocumentationService::isValidDocType(doc_type)) {
+                    crow::json::wvalue error;
+                    error["error"] = "Invalid documentation type";
+                    error["details"] = "doc_type must start with 'internal_' or 'external_' (e.g., 'internal_api', 'external_user_manual')";
+                    return crow::response(400, error);
+                }
+
+                nlohmann::json job;
+                try {
+                    job = doc_jobs->submit(repo_id, doc_type, audience, mode, force);
+                } catch (const std::exception& e) {
+                    crow::json::wvalue error;
+                    error["error"] = "Queue full";
+                    error["details"] = e.what();
+                    return crow::response(503, error);
+                }
+
+                job["status"] = "success";
+                crow::response res(202, job.dump());
+                res.add_header("Content-Type", "application/json");
+                return res;
+
+            } catch (const std::exception& e) {
+                logError("Submit documentation job endpoint", e);
+                crow::json::wvalue error;
+                error["error"] = "Internal server error";
+                error["details"] = e.what();
+                return crow::response(500, error);
+            }
+        });
+
+        CROW_ROUTE(app, "/api/docs/jobs")
+        ([&doc_jobs](){
+            logRequest("GET", "/api/docs/jobs");
+
+            nlohmann::json response = doc_jobs->getStatus();
+            response["status"] = "success";
+
+            crow::response res(200, response.dump());
+            res.add_header("Content-Type", "application/json");
+            return res;
+        });
+
+        CROW_ROUTE(app, "/api/docs/jobs/<int>").methods(crow::HTTPMethod::Get, crow::HTTPMethod::Delete)
+        ([&doc_jobs](const crow::request& req, long long job_id){
+            bool is_delete = req.method == crow::HTTPMethod::Delete;
+            logRequest(is_delete ? "DELETE" : "GET", "/api/docs/jobs/" + std::to_string(job_id));
+
+            try {
+                nlohmann::json response;
+                if (is_delete) {
+                    response["cancelled"] = doc_jobs->cancel(job_id);
+                    response["job_id"] = job_id;
+                } else {
+                    // Long-poll: hold the request until the job finishes, capped so proxies don't time out.
+                    // With every long-poll slot taken the job queue answers at once with poll_after_ms.
+                    const char* wait_param = req.url_params.get("wait");
+                    int wait_sec = wait_param ? std::min(std::max(std::atoi(wait_param), 0), 60) : 0;
+                    response = doc_jobs->getJob(job_id, std::chrono::seconds(wait_sec));
+                }
+                response["status"] = "success";
+
+                crow::response res(200, response.dump());
+                res.add_header("Content-Type", "application/json");
+                return res;
+
+            } catch (const std::exception& e) {
+                crow::json::wvalue error;
+                error["error"] = "Job not found";
+                error["details"] = e.what();
+                return crow::response(404, error);
+            }
+        });
+
+        // Streaming documentation generation. Crow has no chunked/SSE responses for route
+        // handlers, so the document is pushed over a WebSocket instead: the client sends the
+        // same JSON body as /api/docs/generate and receives {"type":"chunk","text":...}
+        // messages as tokens arrive, then {"type":"done"} or {"type":"error"}. Closing the
+        // socket cancels the generation.
+        std::mutex doc_streams_mutex;
+        std::map<crow::websocket::connection*, std::shared_ptr<DocStreamSession>> doc_streams;
+
+        CROW_WEBSOCKET_ROUTE(app, "/api/docs/generate/stream")
+            .onopen([&doc_streams, &doc_streams_mutex](crow::websocket::connection& conn) {
+                logRequest("WS", "/api/docs/generate/stream");
+                std::lock_guard<std::mutex> lock(doc_streams_mutex);
+                doc_streams[&conn] = std::make_shared<DocStreamSession>(&conn);
+            })
+            .onclose([&doc_streams, &doc_streams_mutex](crow::websocket::connection& conn, const std::string& /*reason*/) {
+                std::shared_ptr<DocStreamSession> session;
+                {
+                    std::lock_guard<std::mutex> lock(doc_streams_mutex);
+                    auto it = doc_streams.find(&conn);
+                    if (it == doc_streams.end()) return;
+                    session = it->second;
+                    doc_streams.erase(it);
+                }
+                session->cancelled = true;
+                std::lock_guard<std::mutex> lock(session->mutex);
+                session->conn = nullptr;
+            })
+            .onmessage([&doc_service, &doc_jobs, &doc_streams, &doc_streams_mutex](crow::websocket::connection& conn,
+                                                                                   const std::string& data, bool /*is_binary*/) {
+                std::shared_ptr<DocStreamSession> session;
+                {
+                    std::lock_guard<std::mutex> lock(doc_streams_mutex);
+                    auto it = doc_streams.find(&conn);
+                    if (it == doc_streams.end()) return;
+                    session = it->second;
+                }
+
+                auto reject = [&session](const std::string& error, const std::string& details) {
+                    session->send({{"type", "error"}, {"error", error}, {"details", details}});
+                };
+
+                json body = json::parse(data, nullptr, false);
+                if (body.is_discarded() || !body.is_object()) {
+                    reject("Invalid JSON format", "Message must be valid JSON");
+                    return;
+                }
+                if (!body.contains("repo_id") || !body.contains("doc_type")) {
+                    reject("Missing required fields", "repo_id and doc_type are required");
+                    return;
+                }
+
+                std::string repo_id = body.value("repo_id", "");
+                std::string doc_type = body.value("doc_type", "");
+                std::string audience = body.value("audience", "developers");
+                std::string mode = body.value("mode", "");
+                bool force = body.value("force", false);
+
+                if (!mode.empty() && !DocumentationService::isValidGenerationMode(mode)) {
+                    reject("Invalid generation mode", "mode must be 'single', 'map_reduce', 'auto' or 'sections'");
+                    return;
+                }
+                if (!DocumentationService::isValidDocType(doc_type)) {
+                    reject("Invalid documentation type",
+                           "doc_type must start with 'internal_' or 'external_' (e.g., 'internal_api', 'external_user_manual')");
+                    return;
+                }
+                bool already_running;
+                {
+                    std::lock_guard<std::mutex> lock(session->mutex);
+                    already_running = session->running;
+                    session->running = true;
+                }
+                if (already_running) {
+                    reject("Generation already running", "Open a new connection per document");
+                    return;
+                }
+
+                std::cout << "📡 Streaming " << doc_type << " documentation for: " << repo_id
+                          << " (audience: " << audience << ")" << std::endl;
+
+                // Generation blocks for minutes; keep it off Crow's I/O threads on a bounded pool
+                bool started = doc_jobs->tryStartStream([doc_service, session, repo_id, doc_type, audience, mode, force]() {
+                    auto start = std::chrono::steady_clock::now();
+                    long long first_chunk_ms = -1;
+                    auto elapsedMs = [&start]() {
+                        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - start).count();
+                    };
+
+                    session->send({{"type", "start"}, {"repo_id", repo_id}, {"doc_type", doc_type}, {"audience", audience}});
+
+                    try {
+                        bool from_cache = false;
+                        doc_service->generateDocumentation(
+                            repo_id, doc_type, audience, mode, force, &from_cache,
+                            [&](const std::string& text) {
+                                if (first_chunk_ms < 0) first_chunk_ms = elapsedMs();
+                                return session->send({{"type", "chunk"}, {"text", text}});
+                            },
+                            &session->cancelled);
+
+                        session->send({{"type", "done"}, {"cached", from_cache},
+                                       {"first_chunk_ms", first_chunk_ms}, {"duration_ms", elapsedMs()}});
+                        std::cout << "✅ Streamed " << doc_type << " documentation (first chunk after "
+                                  << first_chunk_ms << " ms)" << std::endl;
+                        session->close("done");
+                    } catch (const GenerationCancelled&) {
+                        std::cout << "⏹️  Stream for " << repo_id << " cancelled by client" << std::endl;
+                    } catch (const std::exception& e) {
+                        logError("Streaming documentation generation", e);
+                        session->send({{"type", "error"}, {"error", "Failed to generate documentation"},
+                                       {"details", e.what()}});
+                        session->close("error");
+                    }
+                });
+
+                if (!started) {
+                    {
+                        std::lock_guard<std::mutex> lock(session->mutex);
+                        session->running = false;
+                    }
+                    reject("Too many streaming generations",
+                           "All " + std::to_string(doc_jobs->streamWorkerCount()) +
+                           " stream workers are busy; retry shortly or submit the request to /api/docs/jobs");
+                }
+            });
+
         // 404 handler for undefined routes
         CROW_CATCHALL_ROUTE(app)
         ([](){
@@ -404,6 +1153,12 @@ int main() {
         
         app.port(8000).multithreaded().run();
         
+        // Stop streams still generating so the job queue can join its stream workers
+        {
+            std::lock_guard<std::mutex> lock(doc_streams_mutex);
+            for (auto& [_, session] : doc_streams) session->cancelled = true;
+        }
+        
     } catch (const std::exception& e) {
         std::cerr << "❌ Fatal error: " << e.what() << std::endl;
         return 1;
@@ -0,0 +1,53 @@
+#!/bin/bash
+
+# Echo - Ollama routing check
+# Starts three stand-in Ollama servers (tools/ollama_standin.py), builds
+# tools/check_ollama_routing.cpp against the backend headers and runs it:
+# request balancing across backends, failover when one dies mid-stream, and
+# embedding-based retrieval. No GPU, models or Ollama install needed.
+#
+# Usage (from backend/): tools/check-ollama-routing.sh
+#   BASE_PORT    first of three local ports to use (default 11510)
+#   JSON_INCLUDE nlohmann/json include directory (default libs/json/include)
+
+set -e
+cd "$(dirname "$0")/.."
+
+BASE_PORT=${BASE_PORT:-11510}
+JSON_INCLUDE=${JSON_INCLUDE:-libs/json/include}
+BUILD_DIR=$(mktemp -d)
+PIDS=()
+
+cleanup() {
+    for pid in "${PIDS[@]}"; do
+        kill "$pid" 2>/dev/null || true
+    done
+    rm -rf "$BUILD_DIR"
+}
+trap cleanup EXIT
+
+echo "🔨 Building routing check..."
+g++ -std=c++17 -O1 -Iinclude -isystem "$JSON_INCLUDE" tools/check_ollama_routing.cpp \
+    -o "$BUILD_DIR/check_ollama_routing" -lcurl -lssl -lcrypto -lz -pthread
+
+echo "🚀 Starting stand-in Ollama servers on ports $BASE_PORT-$((BASE_PORT + 2))..."
+python3 tools/ollama_standin.py "$BASE_PORT" 0.05 0 m:latest,nomic-embed-text &
+FAST_PID=$!
+PIDS+=("$FAST_PID")
+python3 tools/ollama_standin.py "$((BASE_PORT + 1))" 0.2 0 m &
+PIDS+=("$!")
+python3 tools/ollama_standin.py "$((BASE_PORT + 2))" 0.01 0 other &
+PIDS+=("$!")
+
+for port in "$BASE_PORT" "$((BASE_PORT + 1))" "$((BASE_PORT + 2))"; do
+    for _ in $(seq 50); do
+        curl -sf "http://127.0.0.1:$port/api/tags" >/dev/null && break
+        sleep 0.1
+    done
+done
+
+"$BUILD_DIR/check_ollama_routing" \
+    "http://127.0.0.1:$BASE_PORT" \
+    "http://127.0.0.1:$((BASE_PORT + 1))" \
+    "http://127.0.0.1:$((BASE_PORT + 2))" \
+    "$FAST_PID"
@@ -0,0 +1,141 @@
+// Balancing, failover and embedding check for LLMService against stand-in Ollama
+// servers (tools/ollama_standin.py). Run it through tools/check-ollama-routing.sh,
+// which starts the stand-ins, builds this file and passes their URLs and the fast
+// server's pid:
+//
+//   check_ollama_routing FAST_URL SLOW_URL OTHER_MODEL_URL FAST_PID
+//
+// FAST and SLOW serve the generation model, FAST about four times quicker; the
+// third only has an unrelated model. Exits non-zero if any expectation fails.
+// Model output is logged as usual; the check's own lines start with ▶, ✓ or ✗.
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <filesystem>
+#include <csignal>
+#include <unistd.h>
+#include "services/LLMService.h"
+#include "services/EmbeddingService.h"
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+static int failures = 0;
+
+static void expect(bool condition, const std::string& what) {
+    std::cout << (condition ? "  ✓ " : "  ✗ ") << what << std::endl;
+    if (!condition) failures++;
+}
+
+// Status entry of one backend from the router's health report
+static json backendStatus(const LLMService& llm, const std::string& url) {
+    json health = llm.getHealth();
+    std::string host = url;
+    while (!host.empty() && host.back() == '/') host.pop_back();
+    for (const auto& backend : health["backends"]) {
+        if (backend.value("host", "") == host) return backend;
+    }
+    return json::object();
+}
+
+// Run threads x per_thread distinct requests (distinct, so none are coalesced); returns errors
+static int runLoad(LLMService& llm, int threads, int per_thread, bool stream) {
+    std::atomic<int> errors{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                std::string prompt = "check prompt " + std::to_string(t) + "/" + std::to_string(i) +
+                                     (stream ? " stream" : "");
+                try {
+                    if (stream) llm.generateStream(prompt, "", [](const std::string&) { return true; });
+                    else llm.generate(prompt);
+                } catch (const std::exception& e) {
+                    errors++;
+                    std::cerr << "    request failed: " << e.what() << std::endl;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    return errors.load();
+}
+
+int main(int argc, char** argv) {
+    if (argc != 5) {
+        std::cerr << "usage: " << argv[0] << " FAST_URL SLOW_URL OTHER_MODEL_URL FAST_PID" << std::endl;
+        return 2;
+    }
+    std::string fast = argv[1], slow = argv[2], other = argv[3];
+    pid_t fast_pid = static_cast<pid_t>(std::atoi(argv[4]));
+
+    fs::path vectors = fs::temp_directory_path() / ("echo-routing-check-" + std::to_string(getpid()));
+    fs::create_directories(vectors);
+    setenv("SUMMARIES_PATH", vectors.c_str(), 1);
+    setenv("OLLAMA_HOSTS", (fast + "," + slow + "," + other).c_str(), 1);
+    setenv("OLLAMA_MODEL", "m", 1);
+    setenv("OLLAMA_EMBED_MODEL", "nomic-embed-text", 1);
+    setenv("OLLAMA_HEALTH_INTERVAL_SEC", "1", 1);
+
+    {
+        auto llm = std::make_shared<LLMService>();
+
+        std::cout << "\n▶ Balancing: 8 threads x 15 blocking requests" << std::endl;
+        int errors = runLoad(*llm, 8, 15, false);
+        json fast_status = backendStatus(*llm, fast);
+        json slow_status = backendStatus(*llm, slow);
+        json other_status = backendStatus(*llm, other);
+        long long fast_requests = fast_status.value("requests", 0LL);
+        long long slow_requests = slow_status.value("requests", 0LL);
+        std::cout << "    fast " << fast_requests << ", slow " << slow_requests << ", other model "
+                  << other_status.value("requests", 0LL) << " requests" << std::endl;
+        expect(errors == 0, "every request succeeded");
+        expect(fast_requests > slow_requests, "the faster backend took more requests");
+        expect(other_status.value("requests", 0LL) == 0, "the backend without the model took none");
+
+        std::cout << "\n▶ Failover: 8 threads x 10 streams, fast backend killed after 300 ms" << std::endl;
+        std::thread killer([fast_pid] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            kill(fast_pid, SIGTERM);
+        });
+        errors = runLoad(*llm, 8, 10, true);
+        killer.join();
+        fast_status = backendStatus(*llm, fast);
+        slow_status = backendStatus(*llm, slow);
+        std::cout << "    " << errors << " streams lost, fast circuit " << fast_status.value("circuit", "?")
+                  << ", slow " << slow_status.value("requests", 0LL) - slow_requests << " more requests" << std::endl;
+        // A stream that already delivered tokens can't move to another backend, so only the
+        // streams in flight at the kill (one per thread at most) may fail
+        expect(errors <= 8, "only streams in flight on the killed backend failed");
+        expect(fast_status.value("circuit", "") != "closed", "the dead backend's circuit opened");
+        expect(slow_status.value("requests", 0LL) > slow_requests, "the slow backend took over");
+        expect(llm->isAvailable(), "the service is still available");
+
+        errors = runLoad(*llm, 8, 5, true);
+        expect(errors == 0, "every stream started after the kill succeeded");
+
+        std::cout << "\n▶ Embeddings and retrieval" << std::endl;
+        auto embedded = llm->embed({"hello world"});
+        expect(embedded.size() == 1 && embedded[0].size() == 256, "embed returns one 256-dimension vector");
+
+        EmbeddingService embeddings(llm);
+        json files = {
+            {"db/migrations.sql", {{"summary", "Database schema migrations for tables and indexes"}}},
+            {"ui/button.js", {{"summary", "Rendering of a clickable button widget"}}},
+            {"net/http_client.cpp", {{"summary", "HTTP client with retries and timeouts"}}}
+        };
+        size_t indexed = embeddings.indexRepository("routing-check", files);
+        auto matches = embeddings.retrieve("routing-check", "database schema tables", 1);
+        expect(indexed == files.size(), "every file was embedded");
+        expect(!matches.empty() && matches[0].first == "db/migrations.sql", "retrieval ranks the matching file first");
+    }
+
+    fs::remove_all(vectors);
+    std::cout << "\n" << (failures == 0 ? "✅ All routing checks passed" : "❌ " + std::to_string(failures) + " checks failed")
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
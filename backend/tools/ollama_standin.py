@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""Stand-in Ollama server for exercising the backend without a GPU or real models.
+
+Implements the endpoints the backend uses:
+  GET  /api/tags                       lists the models given on the command line
+  POST /api/generate                   streamed (NDJSON) or blocking text, with eval stats
+  POST /api/embed, /api/embeddings     256-dimension hashed bag-of-words vectors
+  GET  /stats                          request counters, for checks
+
+Usage: ollama_standin.py PORT [DELAY_SEC] [PAD_WORDS] [MODEL,MODEL,...]
+
+DELAY_SEC is how long one generation takes; it is also reported as eval_duration
+for 20 tokens, so a larger delay makes the backend look slower to the router.
+PAD_WORDS appends filler words to every generated text.
+"""
+
+import hashlib
+import json
+import re
+import sys
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+PORT = int(sys.argv[1]) if len(sys.argv) > 1 else 11434
+DELAY = float(sys.argv[2]) if len(sys.argv) > 2 else 0.2
+PAD = int(sys.argv[3]) if len(sys.argv) > 3 else 0
+MODELS = [m for m in sys.argv[4].split(",") if m] if len(sys.argv) > 4 else []
+EMBEDDING_DIMENSIONS = 256
+EVAL_TOKENS = 20
+
+lock = threading.Lock()
+stats = {"generate": 0, "active": 0, "max_active": 0, "embed": 0, "connections": 0}
+
+
+def embed_text(text):
+    vector = [0.0] * EMBEDDING_DIMENSIONS
+    for word in re.findall(r"[a-z]+", text.lower()):
+        vector[int(hashlib.md5(word.encode()).hexdigest(), 16) % EMBEDDING_DIMENSIONS] += 1.0
+    # Never all zeros, so cosine similarity stays defined
+    vector[-1] += 0.01
+    return vector
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    # Small responses on a kept-alive connection otherwise wait on delayed ACKs
+    disable_nagle_algorithm = True
+
+    def setup(self):
+        super().setup()
+        with lock:
+            stats["connections"] += 1
+
+    def log_message(self, *args):
+        pass
+
+    def send_json(self, obj, code=200):
+        body = json.dumps(obj).encode()
+        self.send_response(code)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def send_chunk(self, obj):
+        data = (json.dumps(obj) + "\n").encode()
+        self.wfile.write(b"%x\r\n%s\r\n" % (len(data), data))
+        self.wfile.flush()
+
+    def do_GET(self):
+        if self.path == "/api/tags":
+            self.send_json({"models": [{"name": model} for model in MODELS]})
+        elif self.path == "/stats":
+            with lock:
+                self.send_json(stats)
+        else:
+            self.send_json({"error": "not found"}, 404)
+
+    def do_POST(self):
+        length = int(self.headers.get("Content-Length", 0))
+        body = json.loads(self.rfile.read(length) or b"{}")
+
+        if self.path == "/api/generate":
+            self.generate(body)
+        elif self.path in ("/api/embed", "/api/embeddings"):
+            with lock:
+                stats["embed"] += 1
+            inputs = body.get("input", body.get("prompt", ""))
+            if isinstance(inputs, str):
+                inputs = [inputs]
+            vectors = [embed_text(text) for text in inputs]
+            if self.path == "/api/embed":
+                self.send_json({"embeddings": vectors})
+            else:
+                self.send_json({"embedding": vectors[0]})
+        else:
+            self.send_json({"error": "not found"}, 404)
+
+    def generate(self, body):
+        with lock:
+            stats["generate"] += 1
+            stats["active"] += 1
+            stats["max_active"] = max(stats["max_active"], stats["active"])
+        try:
+            prompt = body.get("prompt", "")
+            text = "## Generated\n\nDoc for prompt of %d chars (sha %s).\n" % (
+                len(prompt), hashlib.sha1(prompt.encode()).hexdigest()[:8]) + "lorem " * PAD
+            final = {"response": "", "done": True, "prompt_eval_count": len(prompt) // 4,
+                     "eval_count": EVAL_TOKENS, "eval_duration": int(DELAY * 1e9)}
+
+            if body.get("stream", True):
+                self.send_response(200)
+                self.send_header("Content-Type", "application/x-ndjson")
+                self.send_header("Transfer-Encoding", "chunked")
+                self.end_headers()
+                for word in text.split(" "):
+                    time.sleep(DELAY / 10)
+                    self.send_chunk({"response": word + " ", "done": False})
+                self.send_chunk(final)
+                self.wfile.write(b"0\r\n\r\n")
+            else:
+                time.sleep(DELAY)
+                self.send_json(dict(final, response=text))
+        finally:
+            with lock:
+                stats["active"] -= 1
+
+
+if __name__ == "__main__":
+    ThreadingHTTPServer(("127.0.0.1", PORT), Handler).serve_forever()
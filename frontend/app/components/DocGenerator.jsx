@@ -7,7 +7,7 @@ import remarkGfm from "remark-gfm";
 
 /**
  * DocGenerator
- * Step 3: Pick doc_type + audience, call /api/docs/generate, show and edit result.
+ * Step 3: Pick doc_type + audience, queue a /api/docs/jobs generation, show and edit result.
  * Left: Editable Markdown
  * Right: Live PDF preview (rendered Markdown)
  */
@@ -6,7 +6,8 @@
  *   GET  /api/health
  *   GET  /api/repos
  *   POST /api/repos/add           { github_url, branch? }
- *   POST /api/docs/generate       { repo_id, doc_type, audience? }
+ *   POST /api/docs/jobs           { repo_id, doc_type, audience? }
+ *   GET  /api/docs/jobs/:id?wait=N
  *
  * Base URL resolution priority:
  *   1) window.__ECHO_API__ (runtime-injected on client)
@@ -24,6 +25,10 @@ const BASE =
 
 
 const DEFAULT_TIMEOUT = 15000;
+// How long each documentation job status request may be held open by the backend
+const JOB_POLL_WAIT_SEC = 25;
+// Delay between status requests the backend answered without waiting (all long-poll slots busy)
+const JOB_SHORT_POLL_MS = 2000;
 
 /**
  * Internal: fetch wrapper with timeout + better error messages.
@@ -129,8 +134,33 @@ async function generateDocumentation(repo_id, doc_type = "internal", audience =
     throw new Error("repo_id must be a non-empty string");
   }
   const payload = { repo_id, doc_type, audience };
-  // Extended timeout for LLM generation (5 minutes to match backend)
-  return await request("/api/docs/generate", { method: "POST", body: payload, timeout: 300000 });
+  // Generation runs as a backend job; long-poll it instead of holding one request open for minutes
+  const job = await request("/api/docs/jobs", { method: "POST", body: payload });
+  const deadline = Date.now() + 600000;
+
+  while (Date.now() < deadline) {
+    const polledAt = Date.now();
+    const status = await request(`/api/docs/jobs/${job.job_id}?wait=${JOB_POLL_WAIT_SEC}`, {
+      timeout: (JOB_POLL_WAIT_SEC + 15) * 1000,
+    });
+    if (status.state === "completed") {
+      return { ...status, status: "success" };
+    }
+    if (status.state === "failed" || status.state === "cancelled") {
+      const err = new Error(status.error || `Documentation job ${status.state}`);
+      err.details = status;
+      throw err;
+    }
+    // The backend declined to hold the request: fall back to short polls
+    const pause = status.poll_after_ms || JOB_SHORT_POLL_MS - (Date.now() - polledAt);
+    if (pause > 0) {
+      await new Promise((resolve) => setTimeout(resolve, pause));
+    }
+  }
+
+  const timeoutErr = new Error(`Documentation job ${job.job_id} did not finish in time`);
+  timeoutErr.code = "ETIMEOUT";
+  throw timeoutErr;
 }
 
 /**
@@ -33,6 +33,12 @@ if [ $? -eq 0 ]; then
     echo ""
     echo "You can now generate AI-powered documentation in Echo."
     echo ""
+
+    # Embedding model used to pick the files most relevant to each doc type (~270MB)
+    echo "📥 Pulling nomic-embed-text embedding model..."
+    docker exec -it echo_ollama ollama pull nomic-embed-text || \
+        echo "⚠️  Embedding model not installed; file selection falls back to heuristics"
+    echo ""
     echo "Optional: Install alternative models:"
     echo "  - Mistral (faster, 4GB):     docker exec -it echo_ollama ollama pull mistral:7b"
     echo "  - CodeLlama (code-focused):  docker exec -it echo_ollama ollama pull codellama:7b"